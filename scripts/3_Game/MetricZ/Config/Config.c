@@ -158,6 +158,8 @@ class MetricZ_Config
 
 		s_Config.file.prom_file_path = string.Format("%1%2.prom", exportDir, fileName);
 		s_Config.file.temp_file_path = string.Format("%1%2.tmp", exportDir, fileName);
+		s_Config.file.shard_file_prefix = string.Format("%1%2_", exportDir, fileName);
+		s_Config.file.snapshot_file_prefix = s_Config.file.shard_file_prefix;
 	}
 
 	/**
@@ -30,6 +30,13 @@ class MetricZ_Constants
 	// File export directory
 	static const string EXPORT_DIR = WORK_DIR + "export/";
 
+	// REST spool directory, segment size in bytes and delay (ms) before a partial segment is written
+	static const string SPOOL_DIR = WORK_DIR + "spool/";
+	static const int SPOOL_SEGMENT_SIZE = 1048576;
+	static const int SPOOL_WRITE_DELAY = 10000;
+	static const int SNAPSHOT_SEGMENT_SIZE = 16777216;
+	static const string HISTORY_DIR = WORK_DIR + "history/";
+
 	// Legacy files support
 	static const string LEGACY_PROM_FILE = "$profile:metricz.prom";
 	static const string LEGACY_TMP_FILE = "$profile:metricz.tmp";
@@ -41,5 +48,15 @@ class MetricZ_Constants
 	// Initial memory reservation for the buffer when no specific limit is set.
 	// Should cover the average number of metrics (2000-3000) + headroom to avoid resizing.
 	static const int SINK_BUFFER_PREALLOC = 4096;
+
+	// Free line buffers and text builders, each, kept by MetricZ_BufferPool between cycles.
+	static const int SINK_BUFFER_POOL_SIZE = 4;
+
+	// Number of entities or lines processed by resumable collectors between frame budget checks.
+	static const int FLUSH_YIELD_STRIDE = 16;
+
+	// Series table size of the REST dictionary payload that starts a new session.
+	// Bounds memory of both sides when series churn (players, vehicles) never stops.
+	static const int MAX_DICTIONARY_SERIES = 200000;
 }
 #endif
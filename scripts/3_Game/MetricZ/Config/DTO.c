@@ -16,8 +16,11 @@ class MetricZ_ConfigDTO
 		file = new MetricZ_ConfigDTO_FileExport();
 		http = new MetricZ_ConfigDTO_HttpExport();
 		disabled_metrics = new MetricZ_ConfigDTO_DisabledMetrics();
+		intervals = new MetricZ_ConfigDTO_Intervals();
 		thresholds = new MetricZ_ConfigDTO_Thresholds();
 		geo = new MetricZ_ConfigDTO_Geo();
+		column_store = new MetricZ_ConfigDTO_ColumnStore();
+		history = new MetricZ_ConfigDTO_History();
 	}
 
 	// Internal configuration version. **Do not modify**.
@@ -35,12 +38,21 @@ class MetricZ_ConfigDTO
 	// Switches to disable specific metric series.
 	ref MetricZ_ConfigDTO_DisabledMetrics disabled_metrics;
 
+	// Per-collector collection intervals.
+	ref MetricZ_ConfigDTO_Intervals intervals;
+
 	// Metric collection thresholds.
 	ref MetricZ_ConfigDTO_Thresholds thresholds;
 
 	// Geographic coordinate settings.
 	ref MetricZ_ConfigDTO_Geo geo;
 
+	// Column store layout for entity metrics.
+	ref MetricZ_ConfigDTO_ColumnStore column_store;
+
+	// On-disk flight recorder of the last scrape cycles.
+	ref MetricZ_ConfigDTO_History history;
+
 	[NonSerialized()]
 	int max_players = 255; // from serverDZ.cfg:maxPlayers
 
@@ -56,8 +68,11 @@ class MetricZ_ConfigDTO
 		file.Normalize();
 		http.Normalize();
 		disabled_metrics.Normalize();
+		intervals.Normalize();
 		thresholds.Normalize();
 		geo.Normalize();
+		column_store.Normalize();
+		history.Normalize();
 
 		max_players = MetricZ_Helpers.GetLimitPlayers();
 		fps_limit = MetricZ_Helpers.GetLimitFPS();
@@ -86,6 +101,12 @@ class MetricZ_ConfigDTO_BaseSettings
 	// Interval in seconds between metric updates.
 	int collect_interval_sec = 15;
 
+	// Time budget in milliseconds per server frame for collecting metrics.
+	// Collectors run one after another until the budget is spent, then continue in the next frame.
+	// Large collectors (players, transports, territories, areas, weapons) yield partway through.
+	// 0 - Legacy mode, one whole collector per frame without yielding.
+	int frame_budget_ms = 2;
+
 	// Disable send minimal telemetry 10-20 minutes after server startup.
 	bool disable_telemetry;
 
@@ -113,6 +134,7 @@ class MetricZ_ConfigDTO_BaseSettings
 
 		init_delay_sec = (int)Math.Clamp(init_delay_sec, 0, 300);
 		collect_interval_sec = (int)Math.Clamp(collect_interval_sec, 0, 900);
+		frame_budget_ms = (int)Math.Clamp(frame_budget_ms, 0, 100);
 	}
 }
 
@@ -153,10 +175,31 @@ class MetricZ_ConfigDTO_FileExport
 	// written to the file to indicate that the server is shut down.
 	bool delete_on_shutdown;
 
+	// Write every collector to its own file `${file_name}_${collector}.prom`
+	// in the export directory instead of one `${file_name}.prom`.
+	// A file is rewritten only when the content of its collector changed,
+	// so collectors with static values cost no disk I/O.
+	// The textfile collector merges all `*.prom` files of the directory.
+	// Ignored with the legacy export path.
+	bool shard;
+
+	// Write binary snapshots `${file_name}_${epoch}.snap` with FileSerializer instead of
+	// the .prom file. Family and series tables are written once per snapshot segment,
+	// every cycle appends only raw values. Convert with `tools/snapshot.py`
+	// to Prometheus text or OpenMetrics. Ignored with the legacy export path.
+	bool snapshot;
+
+	// Number of newest snapshot segments (16 MiB each) kept on disk.
+	int snapshot_segments = 4;
+
 	[NonSerialized()]
 	string prom_file_path;
 	[NonSerialized()]
 	string temp_file_path;
+	[NonSerialized()]
+	string shard_file_prefix;
+	[NonSerialized()]
+	string snapshot_file_prefix;
 
 	/**
 	    \brief Normalizes configuration values within valid ranges.
@@ -164,6 +207,7 @@ class MetricZ_ConfigDTO_FileExport
 	void Normalize()
 	{
 		buffer = (int)Math.Clamp(buffer, -1, MetricZ_Constants.MAX_BUFFER_SIZE);
+		snapshot_segments = (int)Math.Clamp(snapshot_segments, 1, 100);
 	}
 }
 
@@ -183,6 +227,20 @@ class MetricZ_ConfigDTO_HttpExport
 	// Recommended: true (approx. 2x faster than buffered text and 5x faster than unbuffered).
 	bool serialized = true;
 
+	// Sends each series (name and labels) once per session, then only compact `id value` lines.
+	// Requires a backend that supports the `format=dict` payload, overrides 'serialized'.
+	// The backend answers `resync` when it lost the table, then all series are sent again.
+	bool dictionary;
+
+	// Uploads only series whose value changed since the last committed transaction,
+	// removed series are sent as stale marks. Every upload becomes a transaction with commit.
+	// Requires a backend that keeps the last state per instance (`mode=delta` commits).
+	bool delta;
+
+	// Number of transactions between full keyframe uploads in delta mode.
+	// A keyframe is also sent after the backend answers `resync` to a commit.
+	int delta_keyframe_every = 20;
+
 	// Buffer size (in lines) per HTTP POST request.
 	// - <= 0 - Disable buffer, send all metrics in one request.
 	// - > 0 - Send metrics chunked by the set line count.
@@ -190,14 +248,38 @@ class MetricZ_ConfigDTO_HttpExport
 	// With 'serialized=true', the buffer setting has minimal impact on CPU performance.
 	// A value of -1 is recommended to reduce the number of HTTP requests.
 	// Use chunking (e.g. 512) only if you encounter network payload limits.
+	// With 'stream=true' chunks are also cut between collectors (see 'stream_min_lines').
 	//
 	// With 'serialized=false' recommended range 64-512 for optimal performance.
 	// HTTP POST is not disk-dependent, but building one huge request body requires more CPU time.
 	int buffer = -1;
 
+	// Posts metrics of finished collectors while the flush state machine runs,
+	// as chunks of one transaction, instead of building the whole payload in the last frame.
+	// With 'buffer=-1' this turns single-request uploads into transactions (ingest chunks + commit),
+	// enable it only with a backend that supports chunked transactions.
+	bool stream;
+
+	// Minimum number of buffered lines posted as one streamed chunk.
+	// Blocks of small collectors are merged until this size, 0 posts every collector separately.
+	int stream_min_lines = 256;
+
 	// Remote URL of the metricz-exporter instance.
+	// Used when 'urls' is empty.
 	string url = "http://127.0.0.1:8098";
 
+	// Remote URLs of several metricz-exporter instances.
+	// Each server picks its primary endpoint by consistent hashing of the instance ID,
+	// so servers of a fleet are spread over the endpoints and keep their endpoint when the list grows.
+	// On connection errors or timeouts requests fail over to the next endpoint.
+	ref array<string> urls;
+
+	// Time (in seconds) after a failover before requests return to the primary endpoint.
+	int failback_sec = 300;
+
+	[NonSerialized()]
+	ref array<string> urls_resolved;
+
 	// Username for Basic Auth protected publishing in metricz-exporter.
 	string user = "metricz";
 
@@ -215,6 +297,39 @@ class MetricZ_ConfigDTO_HttpExport
 	// Maximum allowed calculated delay (in milliseconds) for retries.
 	int retry_max_backoff_ms = 5000;
 
+	// Maximum number of chunk requests sent and not finished yet (retry backoff included).
+	// Further chunks wait in a FIFO queue until a request finishes.
+	int max_in_flight = 4;
+
+	// Maximum size (in KiB) of chunk bodies waiting in the queue.
+	// When exceeded, all queued chunks of the oldest transaction are dropped.
+	int queue_limit_kb = 16384;
+
+	// Maximum number of transactions uploaded at the same time.
+	// A slow upload keeps its transaction while the next cycles start, commits are sent in order.
+	// When the window is full, the oldest transaction is dropped.
+	int max_transactions = 4;
+
+	// Number of consecutive failed transactions that opens the circuit breaker.
+	// While open, REST cycles skip collection and serialization, failed requests are not retried.
+	// - 0 - Disable circuit breaker.
+	int breaker_failures = 3;
+
+	// Interval (in seconds) between probe requests while the circuit breaker is open.
+	// The first successful request closes the breaker.
+	int breaker_probe_sec = 30;
+
+	// Writes chunks that failed all retries to `$profile:metricz/spool/` and replays them
+	// after the backend recovers, with `replay=<epoch>` query outside of transactions.
+	// Not used for 'dictionary' and 'delta' payloads.
+	bool spool;
+
+	// Maximum size (in MiB) of the spool directory, the oldest data is deleted first.
+	int spool_limit_mb = 64;
+
+	// Interval (in milliseconds) between replayed chunks, one chunk is in flight at a time.
+	int spool_replay_interval_ms = 1000;
+
 	// Timeout in seconds for read operations.
 	int read_timeout_sec = 5;
 
@@ -231,13 +346,36 @@ class MetricZ_ConfigDTO_HttpExport
 			buffer = -1;
 
 		url = MetricZ_Helpers.GetActiveURL(url, user, password);
+
+		urls_resolved = new array<string>();
+		if (urls) {
+			foreach (string endpoint : urls) {
+				string resolved = MetricZ_Helpers.GetActiveURL(endpoint, user, password);
+				if (resolved != string.Empty && urls_resolved.Find(resolved) == -1)
+					urls_resolved.Insert(resolved);
+			}
+		}
+
+		if (urls_resolved.Count() == 0 && url != string.Empty)
+			urls_resolved.Insert(url);
+
+		failback_sec = (int)Math.Clamp(failback_sec, 10, 86400);
+		stream_min_lines = (int)Math.Clamp(stream_min_lines, 0, MetricZ_Constants.MAX_BUFFER_SIZE);
+		delta_keyframe_every = (int)Math.Clamp(delta_keyframe_every, 1, 1000);
 		max_retries = (int)Math.Clamp(max_retries, 0, 10);
 		retry_delay_ms = (int)Math.Clamp(retry_delay_ms, 100, MetricZ_Config.Get().settings.init_delay_sec * 1000);
 		retry_max_backoff_ms = (int)Math.Clamp(retry_max_backoff_ms, 1000, MetricZ_Config.Get().settings.collect_interval_sec * 1000);
+		max_in_flight = (int)Math.Clamp(max_in_flight, 1, 64);
+		queue_limit_kb = (int)Math.Clamp(queue_limit_kb, 64, 1048576);
+		max_transactions = (int)Math.Clamp(max_transactions, 1, 32);
+		breaker_failures = (int)Math.Clamp(breaker_failures, 0, 100);
+		breaker_probe_sec = (int)Math.Clamp(breaker_probe_sec, 5, 3600);
+		spool_limit_mb = (int)Math.Clamp(spool_limit_mb, 1, 4096);
+		spool_replay_interval_ms = (int)Math.Clamp(spool_replay_interval_ms, 100, 60000);
 		read_timeout_sec = (int)Math.Clamp(read_timeout_sec, 3, 120);
 		connect_timeout_sec = (int)Math.Clamp(connect_timeout_sec, 3, 120);
 
-		if (url == string.Empty) {
+		if (urls_resolved.Count() == 0) {
 			enabled = false;
 			ErrorEx("MetricZ: rest-url is empty", ErrorExSeverity.WARNING);
 		}
@@ -319,6 +457,70 @@ class MetricZ_ConfigDTO_DisabledMetrics
 	void Normalize() {}
 }
 
+/**
+    \brief Per-collector collection intervals.
+*/
+class MetricZ_ConfigDTO_Intervals
+{
+	// Collection interval in seconds for each collector.
+	// On cycles where a collector is not due, its lines rendered on the last collection are written again,
+	// so the output stays complete. Values of 0 (or below `settings.collect_interval_sec`) collect every cycle.
+	int world;
+
+	// Collection interval in seconds for player metrics.
+	int players;
+
+	// Collection interval in seconds for zombie metrics.
+	int zombies;
+
+	// Collection interval in seconds for animal metrics.
+	int animals;
+
+	// Collection interval in seconds for transport metrics.
+	int transports;
+
+	// Collection interval in seconds for weapon metrics.
+	int weapons;
+
+	// Collection interval in seconds for hit metrics.
+	int hits;
+
+	// Collection interval in seconds for territory flag metrics.
+	// Flag lifetime changes slowly, 60 is a good value for servers with many flags.
+	int territories;
+
+	// Collection interval in seconds for EffectArea metrics.
+	int areas;
+
+	// Collection interval in seconds for RPC metrics.
+	int rpc;
+
+	// Collection interval in seconds for event handler metrics.
+	int events;
+
+	// Collection interval in seconds for http metrics.
+	int http;
+
+	/**
+	    \brief Normalizes configuration values within valid ranges.
+	*/
+	void Normalize()
+	{
+		world = (int)Math.Clamp(world, 0, 3600);
+		players = (int)Math.Clamp(players, 0, 3600);
+		zombies = (int)Math.Clamp(zombies, 0, 3600);
+		animals = (int)Math.Clamp(animals, 0, 3600);
+		transports = (int)Math.Clamp(transports, 0, 3600);
+		weapons = (int)Math.Clamp(weapons, 0, 3600);
+		hits = (int)Math.Clamp(hits, 0, 3600);
+		territories = (int)Math.Clamp(territories, 0, 3600);
+		areas = (int)Math.Clamp(areas, 0, 3600);
+		rpc = (int)Math.Clamp(rpc, 0, 3600);
+		events = (int)Math.Clamp(events, 0, 3600);
+		http = (int)Math.Clamp(http, 0, 3600);
+	}
+}
+
 /**
     \brief Metric collection thresholds.
 */
@@ -332,6 +534,11 @@ class MetricZ_ConfigDTO_Thresholds
 	// Values of -1 or less disable this threshold.
 	float hit_damage_vehicle = 15;
 
+	// Frame time thresholds in milliseconds for counting long frames (hitches).
+	// Each value produces a `dayz_metricz_frames_over_threshold_total{threshold_ms="..."}` series.
+	// Up to 8 values in the range 1-60000.
+	ref array<int> frame_hitch_ms = {33, 100, 500};
+
 	/**
 	    \brief Normalizes configuration values within valid ranges.
 	*/
@@ -339,6 +546,18 @@ class MetricZ_ConfigDTO_Thresholds
 	{
 		hit_damage = Math.Clamp(hit_damage, -1, 100);
 		hit_damage_vehicle = Math.Clamp(hit_damage_vehicle, -15, 100);
+
+		if (!frame_hitch_ms)
+			frame_hitch_ms = new array<int>();
+
+		for (int i = frame_hitch_ms.Count() - 1; i >= 0; i--) {
+			if (frame_hitch_ms[i] < 1 || frame_hitch_ms[i] > 60000)
+				frame_hitch_ms.Remove(i);
+		}
+
+		frame_hitch_ms.Sort();
+		while (frame_hitch_ms.Count() > 8)
+			frame_hitch_ms.Remove(frame_hitch_ms.Count() - 1);
 	}
 }
 
@@ -383,4 +602,51 @@ class MetricZ_ConfigDTO_Geo
 		}
 	}
 }
+
+/**
+    \brief Column store layout for entity metrics.
+*/
+class MetricZ_ConfigDTO_ColumnStore
+{
+	// Keeps player metric values in per-family column arrays indexed by player slot
+	// and renders each family in one loop over these arrays instead of visiting every player metrics object.
+	// Experimental, intended for comparing against the default per-entity layout.
+	bool players;
+
+	// Use column store layout for transport metrics.
+	bool transports;
+
+	// Use column store layout for territory flag metrics.
+	bool territories;
+
+	// Use column store layout for EffectArea metrics.
+	bool areas;
+
+	/**
+	    \brief Normalizes configuration values within valid ranges.
+	*/
+	void Normalize() {}
+}
+
+/**
+    \brief On-disk flight recorder of the last scrape cycles.
+*/
+class MetricZ_ConfigDTO_History
+{
+	// Keeps Prometheus text of the last cycles in `$profile:metricz/history/`
+	// for post-mortems after a crash or freeze, extract them with `tools/history.sh`.
+	// Text already built by the export sinks is reused, the cost is one extra file write per chunk.
+	bool enabled;
+
+	// Number of cycles in the ring, one file per cycle rewritten in place.
+	int cycles = 40;
+
+	/**
+	    \brief Normalizes configuration values within valid ranges.
+	*/
+	void Normalize()
+	{
+		cycles = (int)Math.Clamp(cycles, 2, 1000);
+	}
+}
 #endif
@@ -8,22 +8,22 @@
 /** Metric type */
 enum MetricZ_MetricType {
 	GAUGE = 0,
-	COUNTER = 1
+	COUNTER = 1,
+	HISTOGRAM = 2
 }
 
 /**
     \brief Base class for Prometheus metrics.
-    \details Stores name, HELP text and type. Prints HELP/TYPE headers.
+    \details References a shared MetricZ_MetricDescriptor with name and HELP/TYPE headers,
+             and stores only per-series state: label block and rendered sample line.
 */
 class MetricZ_MetricBase
 {
-	protected string m_Name;
-	protected string m_Help;
-	protected string m_Type;
+	protected MetricZ_MetricDescriptor m_Desc; //!< Shared family descriptor, owned by the descriptor registry
 	protected string m_Labels;
-	protected string m_CachedPrefix;
 	protected string m_CachedMetric;
-	protected MetricZ_MetricType m_EType;
+	protected bool m_Dirty = true; //!< Value or labels changed since m_CachedMetric was rendered
+	protected MetricZ_MetricColumn m_Column; //!< Column holding value and labels of a shared handle, null for own storage
 
 	/**
 	    \brief Constructor.
@@ -33,13 +33,7 @@ class MetricZ_MetricBase
 	*/
 	void MetricZ_MetricBase(string name, string help, MetricZ_MetricType type = 0)
 	{
-		m_Name = string.Format("%1%2", MetricZ_Constants.NAMESPACE, name);
-		if (type == MetricZ_MetricType.COUNTER)
-			m_Name += "_total";
-
-		m_EType = type;
-		m_Help = string.Format("# HELP %1 %2", m_Name, help);
-		m_Type = string.Format("# TYPE %1 %2", m_Name, TypeToText());
+		m_Desc = MetricZ_MetricDescriptor.Get(name, help, type);
 	}
 
 	/**
@@ -51,9 +45,14 @@ class MetricZ_MetricBase
 	*/
 	void SetLabels(string raw)
 	{
+		if (m_Column) {
+			m_Column.SetLabels(raw);
+			return;
+		}
+
 		m_Labels = raw;
 
-		UpdateCachedPrefix();
+		InvalidateCache();
 	}
 
 	/**
@@ -69,7 +68,7 @@ class MetricZ_MetricBase
 	{
 		m_Labels = MetricZ_LabelUtils.MakeLabels(labels);
 
-		UpdateCachedPrefix();
+		InvalidateCache();
 	}
 
 	/**
@@ -85,7 +84,7 @@ class MetricZ_MetricBase
 		labels.Insert(key, value);
 		m_Labels = MetricZ_LabelUtils.MakeLabels(labels);
 
-		UpdateCachedPrefix();
+		InvalidateCache();
 	}
 
 	/**
@@ -94,7 +93,7 @@ class MetricZ_MetricBase
 	*/
 	string GetName()
 	{
-		return m_Name;
+		return m_Desc.GetName();
 	}
 
 	/**
@@ -103,7 +102,7 @@ class MetricZ_MetricBase
 	*/
 	string GetHelp()
 	{
-		return m_Help;
+		return m_Desc.GetHelp();
 	}
 
 	/**
@@ -112,7 +111,7 @@ class MetricZ_MetricBase
 	*/
 	string GetType()
 	{
-		return m_Type;
+		return m_Desc.GetType();
 	}
 
 	/**
@@ -121,7 +120,16 @@ class MetricZ_MetricBase
 	*/
 	MetricZ_MetricType GetMetricType()
 	{
-		return m_EType;
+		return m_Desc.GetMetricType();
+	}
+
+	/**
+	    \brief Get shared family descriptor.
+	    \return \p MetricZ_MetricDescriptor
+	*/
+	MetricZ_MetricDescriptor GetDescriptor()
+	{
+		return m_Desc;
 	}
 
 	/**
@@ -158,6 +166,17 @@ class MetricZ_MetricBase
 		return (m_Labels != string.Empty);
 	}
 
+	/**
+	    \brief Turn this metric into a shared handle of a column.
+	    \details A bound handle keeps no value or labels of its own: setters, getters and
+	             SetLabels() go to the column slot selected by MetricZ_MetricColumn::Seek().
+	    \param column Column of the metric family
+	*/
+	void BindColumn(MetricZ_MetricColumn column)
+	{
+		m_Column = column;
+	}
+
 	/**
 	    \brief Write HELP and TYPE headers.
 	    \param MetricZ_SinkBase sink instance
@@ -167,8 +186,8 @@ class MetricZ_MetricBase
 		if (!sink)
 			return;
 
-		sink.Line(m_Help);
-		sink.Line(m_Type);
+		sink.Line(m_Desc.GetHelp());
+		sink.Line(m_Desc.GetType());
 	}
 
 	/**
@@ -182,12 +201,12 @@ class MetricZ_MetricBase
 			return;
 
 		if (labels != string.Empty) {
-			sink.Line(string.Format("%1%2 0", m_Name, labels));
+			sink.Line(string.Format("%1%2 0", m_Desc.GetName(), labels));
 			return;
 		}
 
-		if (m_CachedMetric == string.Empty)
-			m_CachedMetric = string.Format("%1 0", GetCachedPrefix());
+		if (m_Dirty)
+			UpdateCachedMetric("0");
 
 		sink.Line(m_CachedMetric);
 	}
@@ -210,55 +229,22 @@ class MetricZ_MetricBase
 	}
 
 	/**
-	    \brief Convert enum type to Prometheus text.
-	    \return "gauge" or "counter"; falls back to "gauge" on error
-	*/
-	protected string TypeToText()
-	{
-		switch (m_EType) {
-		case MetricZ_MetricType.GAUGE:
-			return "gauge";
-
-		case MetricZ_MetricType.COUNTER:
-			return "counter";
-		}
-
-		ErrorEx("MetricZ: invalid metric type " + m_EType.ToString() + " for " + m_Name);
-		return "gauge";
-	}
-
-	/**
-	    \brief Updates cached metric name with labels and value for reduce allocations in Flush time
+	    \brief Render cached metric line with labels and value.
+	    \details Called from Flush() only when the value is dirty, value setters just mark it.
 	*/
 	protected void UpdateCachedMetric(string stringValue)
 	{
-		m_CachedMetric = string.Format("%1 %2", GetCachedPrefix(), stringValue);
+		m_CachedMetric = string.Format("%1%2 %3", m_Desc.GetName(), GetLabels(), stringValue);
+		m_Dirty = false;
 	}
 
 	/**
-	    \brief Updates cached metric name with labels prefix for reduce allocations
+	    \brief Drop rendered sample line after labels change.
 	*/
-	protected void UpdateCachedPrefix()
+	protected void InvalidateCache()
 	{
-		string label = m_Labels;
-		if (label == string.Empty)
-			label = MetricZ_LabelUtils.MakeLabels();
-
-		m_CachedPrefix = string.Format("%1%2", m_Name, label);
 		m_CachedMetric = string.Empty;
-	}
-
-	/**
-	    \brief Return cached metric name with labels prefix and update it if need
-	*/
-	protected string GetCachedPrefix()
-	{
-		if (m_CachedPrefix != string.Empty)
-			return m_CachedPrefix;
-
-		UpdateCachedPrefix();
-
-		return m_CachedPrefix;
+		m_Dirty = true;
 	}
 }
 #endif
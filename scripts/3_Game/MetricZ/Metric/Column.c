@@ -0,0 +1,186 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Column of one metric family for many series.
+    \details Parallel arrays of values, label blocks and rendered sample lines indexed by slot.
+             The arrays are the only storage of the series: one metric handle bound via
+             MetricZ_MetricBase::BindColumn() is shared by all series of the family
+             and reads and writes the slot selected by Seek().
+*/
+class MetricZ_MetricColumn
+{
+	protected MetricZ_MetricDescriptor m_Desc; //!< Shared family descriptor
+	protected bool m_IsInt; //!< Values are stored in m_Ints instead of m_Floats
+	protected ref array<int> m_Ints = new array<int>(); //!< Integer values by slot
+	protected ref array<float> m_Floats = new array<float>(); //!< Float values by slot
+	protected ref array<string> m_Labels = new array<string>(); //!< Label blocks by slot
+	protected ref array<string> m_Lines = new array<string>(); //!< Rendered sample lines by slot
+	protected ref array<bool> m_Dirty = new array<bool>(); //!< Line must be re-rendered
+	protected int m_Slot = -1; //!< Slot used by the bound handle, -1 drops writes
+
+	/**
+	    \brief Constructor.
+	    \param desc Family descriptor
+	    \param isInt Store integer values
+	*/
+	void MetricZ_MetricColumn(MetricZ_MetricDescriptor desc, bool isInt)
+	{
+		m_Desc = desc;
+		m_IsInt = isInt;
+	}
+
+	/**
+	    \brief Get shared family descriptor.
+	    \return \p MetricZ_MetricDescriptor
+	*/
+	MetricZ_MetricDescriptor GetDescriptor()
+	{
+		return m_Desc;
+	}
+
+	/**
+	    \brief Grow arrays to hold at least `slots` series.
+	    \param slots Number of slots
+	*/
+	void Resize(int slots)
+	{
+		if (m_Lines.Count() >= slots)
+			return;
+
+		if (m_IsInt)
+			m_Ints.Resize(slots);
+		else
+			m_Floats.Resize(slots);
+
+		m_Labels.Resize(slots);
+		m_Lines.Resize(slots);
+		m_Dirty.Resize(slots);
+	}
+
+	/**
+	    \brief Select the slot the bound handle reads and writes.
+	    \param slot Slot index, -1 to drop writes
+	*/
+	void Seek(int slot)
+	{
+		m_Slot = slot;
+	}
+
+	/**
+	    \brief Get integer value of the current slot.
+	*/
+	int GetInt()
+	{
+		if (m_Slot < 0)
+			return 0;
+
+		return m_Ints[m_Slot];
+	}
+
+	/**
+	    \brief Get float value of the current slot.
+	*/
+	float GetFloat()
+	{
+		if (m_Slot < 0)
+			return 0;
+
+		return m_Floats[m_Slot];
+	}
+
+	/**
+	    \brief Set integer value of the current slot.
+	*/
+	void SetInt(int value)
+	{
+		if (m_Slot < 0 || m_Ints[m_Slot] == value)
+			return;
+
+		m_Ints[m_Slot] = value;
+		m_Dirty[m_Slot] = true;
+	}
+
+	/**
+	    \brief Set float value of the current slot.
+	*/
+	void SetFloat(float value)
+	{
+		if (m_Slot < 0 || m_Floats[m_Slot] == value)
+			return;
+
+		m_Floats[m_Slot] = value;
+		m_Dirty[m_Slot] = true;
+	}
+
+	/**
+	    \brief Set label block of the current slot.
+	    \param labels Prometheus label block with braces
+	*/
+	void SetLabels(string labels)
+	{
+		if (m_Slot < 0)
+			return;
+
+		m_Labels[m_Slot] = labels;
+		m_Dirty[m_Slot] = true;
+	}
+
+	/**
+	    \brief Reset slot state before it is reused.
+	*/
+	void Clear(int slot)
+	{
+		if (m_IsInt)
+			m_Ints[slot] = 0;
+		else
+			m_Floats[slot] = 0;
+
+		m_Labels[slot] = string.Empty;
+		m_Lines[slot] = string.Empty;
+		m_Dirty[slot] = true;
+	}
+
+	/**
+	    \brief Write HELP and TYPE headers.
+	    \param sink MetricZ_SinkBase sink instance
+	*/
+	void WriteHeaders(MetricZ_SinkBase sink)
+	{
+		sink.Line(m_Desc.GetHelp());
+		sink.Line(m_Desc.GetType());
+	}
+
+	/**
+	    \brief Write sample line of a slot, rendering it if the value or labels changed.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param slot Slot index
+	*/
+	void FlushAt(MetricZ_SinkBase sink, int slot)
+	{
+		if (sink.TakesSamples()) {
+			if (m_IsInt)
+				sink.SampleInt(m_Desc, m_Labels[slot], m_Ints[slot]);
+			else
+				sink.SampleFloat(m_Desc, m_Labels[slot], m_Floats[slot]);
+
+			return;
+		}
+
+		if (m_Dirty[slot]) {
+			if (m_IsInt)
+				m_Lines[slot] = string.Format("%1%2 %3", m_Desc.GetName(), m_Labels[slot], m_Ints[slot]);
+			else
+				m_Lines[slot] = string.Format("%1%2 %3", m_Desc.GetName(), m_Labels[slot], m_Floats[slot]);
+
+			m_Dirty[slot] = false;
+		}
+
+		sink.Line(m_Lines[slot]);
+	}
+}
+#endif
@@ -0,0 +1,133 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Immutable description of a metric family.
+    \details Holds full metric name and pre-rendered HELP/TYPE lines.
+             Instances are shared through Get(), so per-entity series
+             (e.g. 30 metrics of every player) reference one descriptor per family
+             instead of carrying their own copies of the header strings.
+*/
+class MetricZ_MetricDescriptor
+{
+	protected static ref map<string, ref MetricZ_MetricDescriptor> s_Registry; //!< Full name -> descriptor
+
+	protected string m_Name; //!< Full metric name with namespace and `_total` suffix for counters
+	protected string m_Help; //!< Rendered `# HELP ...` line
+	protected string m_Type; //!< Rendered `# TYPE ...` line
+	protected MetricZ_MetricType m_EType; //!< Metric type
+	protected int m_Id; //!< Dense index in registration order
+
+	/**
+	    \brief Constructor, use Get() to obtain shared instances.
+	    \param name Full metric name
+	    \param help HELP text
+	    \param type Metric type (GAUGE/COUNTER/HISTOGRAM)
+	*/
+	void MetricZ_MetricDescriptor(string name, string help, MetricZ_MetricType type)
+	{
+		m_Name = name;
+		m_EType = type;
+		m_Help = string.Format("# HELP %1 %2", m_Name, help);
+		m_Type = string.Format("# TYPE %1 %2", m_Name, TypeToText());
+	}
+
+	/**
+	    \brief Get shared descriptor for a metric family, create it on first request.
+	    \details The first registration of a name wins, later HELP text for the same name is ignored.
+	    \param name Metric name without namespace
+	    \param help HELP text
+	    \param type Metric type (GAUGE/COUNTER/HISTOGRAM)
+	    \return \p MetricZ_MetricDescriptor Shared instance
+	*/
+	static MetricZ_MetricDescriptor Get(string name, string help, MetricZ_MetricType type = 0)
+	{
+		if (!s_Registry)
+			s_Registry = new map<string, ref MetricZ_MetricDescriptor>();
+
+		string fullName = MetricZ_Constants.NAMESPACE + name;
+		if (type == MetricZ_MetricType.COUNTER)
+			fullName += "_total";
+
+		MetricZ_MetricDescriptor desc;
+		if (s_Registry.Find(fullName, desc))
+			return desc;
+
+		desc = new MetricZ_MetricDescriptor(fullName, help, type);
+		desc.m_Id = s_Registry.Count();
+		s_Registry.Insert(fullName, desc);
+
+		return desc;
+	}
+
+	/**
+	    \brief Get full metric name.
+	    \return \p string
+	*/
+	string GetName()
+	{
+		return m_Name;
+	}
+
+	/**
+	    \brief Get dense family index, usable as an array index by sinks.
+	    \return \p int
+	*/
+	int GetId()
+	{
+		return m_Id;
+	}
+
+	/**
+	    \brief Get rendered HELP line.
+	    \return \p string `# HELP ...`
+	*/
+	string GetHelp()
+	{
+		return m_Help;
+	}
+
+	/**
+	    \brief Get rendered TYPE line.
+	    \return \p string `# TYPE ...`
+	*/
+	string GetType()
+	{
+		return m_Type;
+	}
+
+	/**
+	    \brief Get metric type enum.
+	    \return \p MetricZ_MetricType
+	*/
+	MetricZ_MetricType GetMetricType()
+	{
+		return m_EType;
+	}
+
+	/**
+	    \brief Convert enum type to Prometheus text.
+	    \return "gauge", "counter" or "histogram"; falls back to "gauge" on error
+	*/
+	protected string TypeToText()
+	{
+		switch (m_EType) {
+		case MetricZ_MetricType.GAUGE:
+			return "gauge";
+
+		case MetricZ_MetricType.COUNTER:
+			return "counter";
+
+		case MetricZ_MetricType.HISTOGRAM:
+			return "histogram";
+		}
+
+		ErrorEx("MetricZ: invalid metric type " + m_EType.ToString() + " for " + m_Name);
+		return "gauge";
+	}
+}
+#endif
@@ -22,6 +22,9 @@ class MetricZ_MetricFloat : MetricZ_MetricBase
 	*/
 	float Get()
 	{
+		if (m_Column)
+			return m_Column.GetFloat();
+
 		return m_Value;
 	}
 
@@ -31,11 +34,16 @@ class MetricZ_MetricFloat : MetricZ_MetricBase
 	*/
 	void Set(float x)
 	{
-		if (m_Value == x && m_CachedMetric != string.Empty)
+		if (m_Column) {
+			m_Column.SetFloat(x);
+			return;
+		}
+
+		if (m_Value == x)
 			return;
 
 		m_Value = x;
-		UpdateCachedMetric(m_Value.ToString());
+		m_Dirty = true;
 	}
 
 	/**
@@ -44,8 +52,13 @@ class MetricZ_MetricFloat : MetricZ_MetricBase
 	*/
 	void Add(float x)
 	{
+		if (m_Column) {
+			m_Column.SetFloat(m_Column.GetFloat() + x);
+			return;
+		}
+
 		m_Value += x;
-		UpdateCachedMetric(m_Value.ToString());
+		m_Dirty = true;
 	}
 
 	/**
@@ -58,12 +71,20 @@ class MetricZ_MetricFloat : MetricZ_MetricBase
 		if (!sink)
 			return;
 
+		if (sink.TakesSamples()) {
+			if (labels == string.Empty)
+				labels = GetLabels();
+
+			sink.SampleFloat(m_Desc, labels, m_Value);
+			return;
+		}
+
 		if (labels != string.Empty) {
-			sink.Line(string.Format("%1%2 %3", m_Name, labels, m_Value));
+			sink.Line(string.Format("%1%2 %3", m_Desc.GetName(), labels, m_Value));
 			return;
 		}
 
-		if (m_CachedMetric == string.Empty)
+		if (m_Dirty)
 			UpdateCachedMetric(m_Value.ToString());
 
 		sink.Line(m_CachedMetric);
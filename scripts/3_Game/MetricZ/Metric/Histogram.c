@@ -0,0 +1,297 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Histogram metric with fixed bucket bounds.
+    \details Observe() costs one binary search over the bounds and one increment.
+             `_bucket{le=...}` prefixes are rendered once per label set, value lines are rendered
+             in Flush() only after new observations.
+             Create with type MetricZ_MetricType.HISTOGRAM and set bounds once with SetBounds().
+        \param name Metric name
+        \param help HELP text
+        \param type Metric type (HISTOGRAM)
+*/
+class MetricZ_MetricHistogram : MetricZ_MetricBase
+{
+	protected ref array<float> m_Bounds = new array<float>(); //!< Upper bounds of buckets
+	protected ref array<int> m_Buckets = new array<int>(); //!< Observations per bucket (not cumulative), last is `+Inf`
+	protected float m_Sum; //!< Sum of observed values
+	protected int m_Count; //!< Number of observations
+
+	protected ref array<string> m_Prefixes = new array<string>(); //!< `name_bucket{labels,le="x"} ` by bucket
+	protected string m_SumPrefix; //!< `name_sum{labels} `
+	protected string m_CountPrefix; //!< `name_count{labels} `
+	protected string m_PrefixLabels; //!< Label block the prefixes were rendered with
+	protected ref array<string> m_Lines = new array<string>(); //!< Rendered bucket, sum and count lines
+
+	/**
+	    \brief Set upper bucket bounds and drop all observations.
+	    \param bounds Upper bounds in ascending order, `+Inf` bucket is implicit
+	*/
+	void SetBounds(array<float> bounds)
+	{
+		m_Bounds.Clear();
+		if (bounds)
+			m_Bounds.Copy(bounds);
+
+		m_Buckets.Clear();
+		m_Buckets.Resize(m_Bounds.Count() + 1);
+		m_Sum = 0;
+		m_Count = 0;
+
+		InvalidateCache();
+	}
+
+	/**
+	    \brief Build exponential bounds `start * factor^i`.
+	    \param start First bound
+	    \param factor Multiplier, must be greater than 1
+	    \param count Number of bounds
+	    \return \p array<float>
+	*/
+	static array<float> ExponentialBounds(float start, float factor, int count)
+	{
+		array<float> bounds = new array<float>();
+		float bound = start;
+		for (int i = 0; i < count; i++) {
+			bounds.Insert(bound);
+			bound *= factor;
+		}
+
+		return bounds;
+	}
+
+	/**
+	    \brief Record one value.
+	    \param x Observed value
+	*/
+	void Observe(float x)
+	{
+		if (m_Buckets.Count() == 0)
+			SetBounds(null);
+
+		int lo = 0;
+		int hi = m_Bounds.Count();
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (x <= m_Bounds[mid])
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+
+		m_Buckets[lo] = m_Buckets[lo] + 1;
+		m_Sum += x;
+		m_Count++;
+		m_Dirty = true;
+	}
+
+	/**
+	    \brief Drop all observations.
+	*/
+	void Reset()
+	{
+		int buckets = m_Buckets.Count();
+		for (int i = 0; i < buckets; i++)
+			m_Buckets[i] = 0;
+
+		m_Sum = 0;
+		m_Count = 0;
+		m_Dirty = true;
+	}
+
+	/**
+	    \brief Get number of observations.
+	    \return \p int
+	*/
+	int GetCount()
+	{
+		return m_Count;
+	}
+
+	/**
+	    \brief Get sum of observed values.
+	    \return \p float
+	*/
+	float GetSum()
+	{
+		return m_Sum;
+	}
+
+	/**
+	    \brief Copy current per-bucket counts, e.g. as a baseline for Quantile().
+	    \param[out] buckets Receives counts, last element is the `+Inf` bucket
+	*/
+	void CopyBuckets(array<int> buckets)
+	{
+		buckets.Copy(m_Buckets);
+	}
+
+	/**
+	    \brief Estimate quantile by linear interpolation inside the bucket.
+	    \details Values in the `+Inf` bucket are reported as the highest finite bound.
+	             With a baseline from CopyBuckets() only observations made after it are used.
+	    \param q Quantile 0..1
+	    \param baseline Optional per-bucket counts to subtract
+	    \return \p float Estimated value, 0 without observations
+	*/
+	float Quantile(float q, array<int> baseline = null)
+	{
+		int bounds = m_Bounds.Count();
+		if (bounds == 0)
+			return 0;
+
+		bool useBaseline = (baseline && baseline.Count() == m_Buckets.Count());
+
+		int total = m_Count;
+		if (useBaseline) {
+			foreach (int prev : baseline)
+				total -= prev;
+		}
+
+		if (total <= 0)
+			return 0;
+
+		float rank = Math.Clamp(q, 0, 1) * total;
+		int seen = 0;
+
+		for (int i = 0; i < bounds; i++) {
+			int inBucket = m_Buckets[i];
+			if (useBaseline)
+				inBucket -= baseline[i];
+
+			if (inBucket > 0 && seen + inBucket >= rank) {
+				float lower = 0;
+				if (i > 0)
+					lower = m_Bounds[i - 1];
+
+				return lower + (m_Bounds[i] - lower) * (rank - seen) / inBucket;
+			}
+
+			seen += inBucket;
+		}
+
+		return m_Bounds[bounds - 1];
+	}
+
+	/**
+	    \brief Write bucket, sum and count lines.
+	    \details Prefixes are cached for the last used label block, so a stable labels override
+	             (e.g. base labels passed by MetricZ_Storage) is rendered only once.
+	    \param MetricZ_SinkBase sink instance
+	    \param labels Optional labels override, if blank try use internal labels
+	*/
+	override void Flush(MetricZ_SinkBase sink, string labels = "")
+	{
+		if (!sink)
+			return;
+
+		if (labels == string.Empty)
+			labels = GetLabels();
+
+		if (labels != m_PrefixLabels || m_Prefixes.Count() == 0)
+			RenderPrefixes(labels);
+
+		if (m_Dirty)
+			RenderLines();
+
+		foreach (string line : m_Lines)
+			sink.Line(line);
+	}
+
+	/**
+	    \brief Write HELP/TYPE then lines.
+	    \param MetricZ_SinkBase sink instance
+	    \param labels Optional labels override, if blank try use internal labels
+	*/
+	override void FlushWithHead(MetricZ_SinkBase sink, string labels = "")
+	{
+		if (!sink)
+			return;
+
+		WriteHeaders(sink);
+		Flush(sink, labels);
+	}
+
+	/**
+	    \brief Drop rendered prefixes and lines after labels change.
+	*/
+	override protected void InvalidateCache()
+	{
+		super.InvalidateCache();
+
+		m_Prefixes.Clear();
+		m_PrefixLabels = string.Empty;
+	}
+
+	/**
+	    \brief Render cumulative bucket lines, sum and count.
+	*/
+	protected void RenderLines()
+	{
+		m_Lines.Clear();
+
+		int cumulative = 0;
+		int buckets = m_Buckets.Count();
+		for (int i = 0; i < buckets; i++) {
+			cumulative += m_Buckets[i];
+			m_Lines.Insert(m_Prefixes[i] + cumulative.ToString());
+		}
+
+		m_Lines.Insert(m_SumPrefix + m_Sum.ToString());
+		m_Lines.Insert(m_CountPrefix + m_Count.ToString());
+
+		m_Dirty = false;
+	}
+
+	/**
+	    \brief Render label prefixes of all lines.
+	    \param labels Label block with braces
+	*/
+	protected void RenderPrefixes(string labels)
+	{
+		string name = m_Desc.GetName();
+
+		m_Prefixes.Clear();
+		int buckets = m_Buckets.Count();
+		for (int i = 0; i < buckets; i++)
+			m_Prefixes.Insert(string.Format("%1_bucket%2 ", name, WithLe(labels, BoundText(i))));
+
+		m_SumPrefix = string.Format("%1_sum%2 ", name, labels);
+		m_CountPrefix = string.Format("%1_count%2 ", name, labels);
+		m_PrefixLabels = labels;
+		m_Dirty = true;
+	}
+
+	/**
+	    \brief Text of bucket upper bound.
+	    \param idx Bucket index
+	    \return \p string Bound value or `+Inf` for the last bucket
+	*/
+	protected string BoundText(int idx)
+	{
+		if (idx >= m_Bounds.Count())
+			return "+Inf";
+
+		return m_Bounds[idx].ToString();
+	}
+
+	/**
+	    \brief Append `le` label to a label block.
+	    \param labels Label block with braces or empty string
+	    \param le Bucket bound text
+	    \return \p string Label block with `le`
+	*/
+	protected static string WithLe(string labels, string le)
+	{
+		if (labels.Length() < 2)
+			return string.Format("{le=\"%1\"}", le);
+
+		return string.Format("%1,le=\"%2\"}", labels.Substring(0, labels.Length() - 1), le);
+	}
+}
+#endif
@@ -21,6 +21,9 @@ class MetricZ_MetricInt : MetricZ_MetricBase
 	*/
 	int Get()
 	{
+		if (m_Column)
+			return m_Column.GetInt();
+
 		return m_Value;
 	}
 
@@ -30,11 +33,16 @@ class MetricZ_MetricInt : MetricZ_MetricBase
 	*/
 	void Set(int x)
 	{
-		if (m_Value == x && m_CachedMetric != string.Empty)
+		if (m_Column) {
+			m_Column.SetInt(x);
+			return;
+		}
+
+		if (m_Value == x)
 			return;
 
 		m_Value = x;
-		UpdateCachedMetric(m_Value.ToString());
+		m_Dirty = true;
 	}
 
 	/**
@@ -42,8 +50,13 @@ class MetricZ_MetricInt : MetricZ_MetricBase
 	*/
 	void Inc()
 	{
+		if (m_Column) {
+			m_Column.SetInt(m_Column.GetInt() + 1);
+			return;
+		}
+
 		m_Value++;
-		UpdateCachedMetric(m_Value.ToString());
+		m_Dirty = true;
 	}
 
 	/**
@@ -52,8 +65,13 @@ class MetricZ_MetricInt : MetricZ_MetricBase
 	*/
 	void Add(int d)
 	{
+		if (m_Column) {
+			m_Column.SetInt(m_Column.GetInt() + d);
+			return;
+		}
+
 		m_Value = m_Value + d;
-		UpdateCachedMetric(m_Value.ToString());
+		m_Dirty = true;
 	}
 
 	/**
@@ -61,8 +79,13 @@ class MetricZ_MetricInt : MetricZ_MetricBase
 	*/
 	void Dec()
 	{
+		if (m_Column) {
+			m_Column.SetInt(m_Column.GetInt() - 1);
+			return;
+		}
+
 		m_Value--;
-		UpdateCachedMetric(m_Value.ToString());
+		m_Dirty = true;
 	}
 
 	/**
@@ -75,12 +98,20 @@ class MetricZ_MetricInt : MetricZ_MetricBase
 		if (!sink)
 			return;
 
+		if (sink.TakesSamples()) {
+			if (labels == string.Empty)
+				labels = GetLabels();
+
+			sink.SampleInt(m_Desc, labels, m_Value);
+			return;
+		}
+
 		if (labels != string.Empty) {
-			sink.Line(string.Format("%1%2 %3", m_Name, labels, m_Value));
+			sink.Line(string.Format("%1%2 %3", m_Desc.GetName(), labels, m_Value));
 			return;
 		}
 
-		if (m_CachedMetric == string.Empty)
+		if (m_Dirty)
 			UpdateCachedMetric(m_Value.ToString());
 
 		sink.Line(m_CachedMetric);
@@ -0,0 +1,295 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Integer gauge/counter family with many label sets.
+    \details Label tuples are mapped to dense slots once, values live in a flat array,
+             label blocks and sample lines are rendered once per slot and re-rendered only after value change.
+             Flush() writes the whole family in one pass over the arrays.
+             Create with Create() or with type GAUGE/COUNTER and SetLabelKeys(), up to 3 label keys.
+             Series are addressed either by label values (Slot()/Find()) or by integer id (SlotId()/FindId()),
+             one vector should use only one of the two ways.
+        \param name Metric name
+        \param help HELP text
+        \param type Metric type (GAUGE/COUNTER)
+*/
+class MetricZ_MetricVector : MetricZ_MetricBase
+{
+	protected ref MetricZ_LabelSchema m_Schema = new MetricZ_LabelSchema(); //!< Label keys of the tuple
+	protected ref map<string, int> m_Index = new map<string, int>(); //!< Joined label values -> slot
+	protected ref map<int, int> m_IdIndex = new map<int, int>(); //!< Integer id -> slot
+	protected bool m_ById; //!< Series are addressed by integer id
+
+	protected ref array<int> m_Values = new array<int>(); //!< Values by slot
+	protected ref array<string> m_SlotLabels = new array<string>(); //!< Rendered label blocks by slot
+	protected ref array<string> m_Lines = new array<string>(); //!< Rendered sample lines by slot
+	protected ref array<bool> m_LineDirty = new array<bool>(); //!< Line must be re-rendered
+	protected ref array<bool> m_Used = new array<bool>(); //!< Slot holds a series
+	protected ref array<string> m_SlotKeys = new array<string>(); //!< Index key by slot
+	protected ref array<int> m_SlotIds = new array<int>(); //!< Integer id by slot
+	protected ref array<int> m_Free = new array<int>(); //!< Removed slots for reuse
+	protected int m_Count; //!< Number of used slots
+
+	/**
+	    \brief Create vector with label keys.
+	    \param name Metric name
+	    \param help HELP text
+	    \param type Metric type (GAUGE/COUNTER)
+	    \param k1 First label key
+	    \param k2 Optional second label key
+	    \param k3 Optional third label key
+	    \return \p MetricZ_MetricVector
+	*/
+	static MetricZ_MetricVector Create(string name, string help, MetricZ_MetricType type, string k1, string k2 = "", string k3 = "")
+	{
+		MetricZ_MetricVector vector = new MetricZ_MetricVector(name, help, type);
+		vector.SetLabelKeys(k1, k2, k3);
+
+		return vector;
+	}
+
+	/**
+	    \brief Set label keys of the tuple.
+	    \details Must be called before the first series is created, empty keys end the tuple.
+	    \param k1 First label key
+	    \param k2 Optional second label key
+	    \param k3 Optional third label key
+	*/
+	void SetLabelKeys(string k1, string k2 = "", string k3 = "")
+	{
+		m_Schema = new MetricZ_LabelSchema();
+		if (k1 == string.Empty)
+			return;
+
+		m_Schema.AddKey(k1);
+		if (k2 == string.Empty)
+			return;
+
+		m_Schema.AddKey(k2);
+		if (k3 != string.Empty)
+			m_Schema.AddKey(k3);
+	}
+
+	/**
+	    \brief Find slot of a label tuple.
+	    \return \p int Slot index or -1 if the series does not exist
+	*/
+	int Find(string v1, string v2 = "", string v3 = "")
+	{
+		int slot;
+		if (m_Index.Find(JoinKey(v1, v2, v3), slot))
+			return slot;
+
+		return -1;
+	}
+
+	/**
+	    \brief Get slot of a label tuple, create series with value 0 if missing.
+	    \return \p int Slot index
+	*/
+	int Slot(string v1, string v2 = "", string v3 = "")
+	{
+		string key = JoinKey(v1, v2, v3);
+
+		int slot;
+		if (m_Index.Find(key, slot))
+			return slot;
+
+		slot = Allocate(m_Schema.Render(v1, v2, v3));
+		m_SlotKeys[slot] = key;
+		m_Index.Insert(key, slot);
+
+		return slot;
+	}
+
+	/**
+	    \brief Find slot of an integer id.
+	    \return \p int Slot index or -1 if the series does not exist
+	*/
+	int FindId(int id)
+	{
+		int slot;
+		if (m_IdIndex.Find(id, slot))
+			return slot;
+
+		return -1;
+	}
+
+	/**
+	    \brief Get slot of an integer id, create series with value 0 if missing.
+	    \details Id is the value of the first label key, other values are used only when the series is created.
+	    \return \p int Slot index
+	*/
+	int SlotId(int id, string v2 = "", string v3 = "")
+	{
+		int slot;
+		if (m_IdIndex.Find(id, slot))
+			return slot;
+
+		m_ById = true;
+		slot = Allocate(m_Schema.Render(id.ToString(), v2, v3));
+		m_SlotIds[slot] = id;
+		m_IdIndex.Insert(id, slot);
+
+		return slot;
+	}
+
+	/**
+	    \brief Get value of a slot.
+	*/
+	int Get(int slot)
+	{
+		return m_Values[slot];
+	}
+
+	/**
+	    \brief Set value of a slot.
+	*/
+	void Set(int slot, int x)
+	{
+		if (m_Values[slot] == x)
+			return;
+
+		m_Values[slot] = x;
+		m_LineDirty[slot] = true;
+	}
+
+	/**
+	    \brief Increment value of a slot by 1.
+	*/
+	void Inc(int slot)
+	{
+		m_Values[slot] = m_Values[slot] + 1;
+		m_LineDirty[slot] = true;
+	}
+
+	/**
+	    \brief Add signed delta to a slot.
+	    \return \p int New value
+	*/
+	int Add(int slot, int d)
+	{
+		int v = m_Values[slot] + d;
+		m_Values[slot] = v;
+		m_LineDirty[slot] = true;
+
+		return v;
+	}
+
+	/**
+	    \brief Drop series of a slot, the slot is reused by the next new series.
+	*/
+	void Remove(int slot)
+	{
+		if (slot < 0 || slot >= m_Used.Count() || !m_Used[slot])
+			return;
+
+		if (m_ById)
+			m_IdIndex.Remove(m_SlotIds[slot]);
+		else
+			m_Index.Remove(m_SlotKeys[slot]);
+
+		m_Used[slot] = false;
+		m_Free.Insert(slot);
+		m_Count--;
+	}
+
+	/**
+	    \brief Number of series.
+	*/
+	int Count()
+	{
+		return m_Count;
+	}
+
+	/**
+	    \brief Write sample lines of all series.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param labels Ignored, every series has own labels
+	*/
+	override void Flush(MetricZ_SinkBase sink, string labels = "")
+	{
+		if (!sink)
+			return;
+
+		string name = m_Desc.GetName();
+		int slots = m_Used.Count();
+		for (int i = 0; i < slots; i++) {
+			if (!m_Used[i])
+				continue;
+
+			if (m_LineDirty[i]) {
+				m_Lines[i] = string.Format("%1%2 %3", name, m_SlotLabels[i], m_Values[i]);
+				m_LineDirty[i] = false;
+			}
+
+			sink.Line(m_Lines[i]);
+		}
+	}
+
+	/**
+	    \brief Write HELP/TYPE then all series, nothing if the vector is empty.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param labels Ignored, every series has own labels
+	*/
+	override void FlushWithHead(MetricZ_SinkBase sink, string labels = "")
+	{
+		if (!sink || m_Count == 0)
+			return;
+
+		WriteHeaders(sink);
+		Flush(sink);
+	}
+
+	/**
+	    \brief Take a free slot or append a new one.
+	    \param slotLabels Rendered label block of the series
+	    \return \p int Slot index
+	*/
+	protected int Allocate(string slotLabels)
+	{
+		int slot;
+		if (m_Free.Count() > 0) {
+			slot = m_Free[m_Free.Count() - 1];
+			m_Free.Remove(m_Free.Count() - 1);
+		} else {
+			slot = m_Used.Count();
+			m_Values.Insert(0);
+			m_SlotLabels.Insert(string.Empty);
+			m_Lines.Insert(string.Empty);
+			m_LineDirty.Insert(true);
+			m_Used.Insert(false);
+			m_SlotKeys.Insert(string.Empty);
+			m_SlotIds.Insert(0);
+		}
+
+		m_Values[slot] = 0;
+		m_SlotLabels[slot] = slotLabels;
+		m_LineDirty[slot] = true;
+		m_Used[slot] = true;
+		m_Count++;
+
+		return slot;
+	}
+
+	/**
+	    \brief Join label values into an index key.
+	*/
+	protected string JoinKey(string v1, string v2, string v3)
+	{
+		switch (m_Schema.Count()) {
+		case 2:
+			return v1 + "|" + v2;
+
+		case 3:
+			return v1 + "|" + v2 + "|" + v3;
+		}
+
+		return v1;
+	}
+}
+#endif
@@ -0,0 +1,170 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/** Circuit breaker state */
+enum MetricZ_BreakerState {
+	CLOSED = 0,
+	OPEN = 1,
+	HALF_OPEN = 2
+}
+
+/**
+    \brief Circuit breaker of the REST export.
+    \details Opens after `http.breaker_failures` consecutive transactions whose requests failed all retries.
+             While open, REST cycles are skipped before collectors run and pending requests stop retrying.
+             Every `http.breaker_probe_sec` one tiny probe chunk is posted (half-open state),
+             the first successful request of any kind closes the breaker again.
+*/
+class MetricZ_RestBreaker
+{
+	protected static MetricZ_BreakerState s_State; //!< Current state
+	protected static int s_Failures; //!< Consecutive failed transactions
+	protected static string s_LastFailedTxn; //!< Transaction of the last counted failure
+	protected static float s_StateAt; //!< Tick time (seconds) of the last state change
+	protected static int s_TotalOpens; //!< Total transitions to open state
+	protected static int s_TotalSkipped; //!< Total cycles skipped while not closed
+
+	// Metrics
+	protected static ref MetricZ_MetricInt s_MetricState = new MetricZ_MetricInt(
+	    "http_breaker_state",
+	    "REST circuit breaker state: 0 closed, 1 open, 2 half-open",
+	    MetricZ_MetricType.GAUGE);
+	protected static ref MetricZ_MetricInt s_MetricOpens = new MetricZ_MetricInt(
+	    "http_breaker_opens",
+	    "Total transitions of the REST circuit breaker to open state",
+	    MetricZ_MetricType.COUNTER);
+	protected static ref MetricZ_MetricInt s_MetricSkipped = new MetricZ_MetricInt(
+	    "http_breaker_skipped_cycles",
+	    "Total REST export cycles skipped by the open circuit breaker",
+	    MetricZ_MetricType.COUNTER);
+
+	/**
+	    \brief Check if the breaker is enabled in config.
+	*/
+	static bool IsEnabled()
+	{
+		return MetricZ_Config.IsLoaded() && MetricZ_Config.Get().http.breaker_failures > 0;
+	}
+
+	/**
+	    \brief Check if REST requests are allowed.
+	*/
+	static bool IsClosed()
+	{
+		return !IsEnabled() || s_State == MetricZ_BreakerState.CLOSED;
+	}
+
+	/**
+	    \brief Decide if the REST export runs in this cycle, call once per cycle before the sink is created.
+	    \details Sends the half-open probe when the open state is older than `http.breaker_probe_sec`.
+	    \return \p bool True if REST export is allowed
+	*/
+	static bool Poll()
+	{
+		if (IsClosed())
+			return true;
+
+		s_TotalSkipped++;
+
+		float age = g_Game.GetTickTime() - s_StateAt;
+		MetricZ_ConfigDTO_HttpExport cfg = MetricZ_Config.Get().http;
+
+		if (s_State == MetricZ_BreakerState.OPEN && age >= cfg.breaker_probe_sec)
+			Probe();
+		else if (s_State == MetricZ_BreakerState.HALF_OPEN && age > cfg.connect_timeout_sec + cfg.read_timeout_sec)
+			SetState(MetricZ_BreakerState.OPEN); // probe response lost
+
+		return false;
+	}
+
+	/**
+	    \brief Report successful request, closes the breaker.
+	*/
+	static void OnSuccess()
+	{
+		s_Failures = 0;
+		s_LastFailedTxn = string.Empty;
+
+		if (s_State == MetricZ_BreakerState.CLOSED)
+			return;
+
+		SetState(MetricZ_BreakerState.CLOSED);
+		ErrorEx("MetricZ: REST backend is reachable again, circuit breaker closed", ErrorExSeverity.INFO);
+	}
+
+	/**
+	    \brief Report request which failed all retries.
+	    \details Failed requests of one transaction count once, a failed probe reopens the breaker.
+	    \param txn Transaction ID of the request, empty for non-transactional requests
+	*/
+	static void OnFailure(string txn = "")
+	{
+		if (!IsEnabled())
+			return;
+
+		if (s_State == MetricZ_BreakerState.HALF_OPEN) {
+			SetState(MetricZ_BreakerState.OPEN);
+			return;
+		}
+
+		if (txn != string.Empty && txn == s_LastFailedTxn)
+			return;
+
+		s_LastFailedTxn = txn;
+		s_Failures++;
+
+		if (s_State != MetricZ_BreakerState.CLOSED || s_Failures < MetricZ_Config.Get().http.breaker_failures)
+			return;
+
+		SetState(MetricZ_BreakerState.OPEN);
+		s_TotalOpens++;
+		ErrorEx(
+		    string.Format("MetricZ: REST circuit breaker open after %1 failed transactions, probe every %2s", s_Failures, MetricZ_Config.Get().http.breaker_probe_sec),
+		    ErrorExSeverity.WARNING);
+	}
+
+	/**
+	    \brief Emit metrics to sink.
+	*/
+	static void Flush(MetricZ_SinkBase sink)
+	{
+		if (!sink || !IsEnabled())
+			return;
+
+		s_MetricState.Set(s_State);
+		s_MetricState.FlushWithHead(sink);
+
+		s_MetricOpens.Set(s_TotalOpens);
+		s_MetricOpens.FlushWithHead(sink);
+
+		s_MetricSkipped.Set(s_TotalSkipped);
+		s_MetricSkipped.FlushWithHead(sink);
+	}
+
+	/**
+	    \brief Switch to half-open and post the probe chunk.
+	*/
+	protected static void Probe()
+	{
+		MetricZ_RestClient client = MetricZ_RestClient.Get();
+		if (!client)
+			return;
+
+		SetState(MetricZ_BreakerState.HALF_OPEN);
+		client.PostProbe(new MetricZ_CallbackProbe(client));
+	}
+
+	/**
+	    \brief Change state and remember the time of change.
+	*/
+	protected static void SetState(MetricZ_BreakerState state)
+	{
+		s_State = state;
+		s_StateAt = g_Game.GetTickTime();
+	}
+}
+#endif
@@ -17,6 +17,9 @@ class MetricZ_CallbackBase : RestCallback
 	private int m_StartedAt; //!< Timestamp when the callback was created (request started)
 	protected ref MetricZ_RestClient m_Client; //!< Reference to client for re-sending requests
 	protected string m_ReqType; //!< Class name of the callback (used for stats tagging)
+	protected int m_Endpoint = -1; //!< Index of the client endpoint of the last attempt
+	protected int m_SentAt; //!< Timestamp of the last attempt
+	private bool m_RetryScheduled; //!< RetryFire() is queued
 
 	/**
 	    \brief Constructor.
@@ -29,10 +32,17 @@ class MetricZ_CallbackBase : RestCallback
 		m_StartedAt = g_Game.GetTime();
 		m_ReqType = ClassName();
 		m_ReqType.Replace("MetricZ_Callback", "");
+
+		MetricZ_HttpStats.AddCallbacks(1);
 	}
 
 	void ~MetricZ_CallbackBase()
 	{
+		MetricZ_HttpStats.AddCallbacks(-1);
+
+		if (m_RetryScheduled)
+			MetricZ_HttpStats.AddScheduledRetries(-1);
+
 #ifdef DIAG
 		ErrorEx("MetricZ: callback " + ClassName() + " destroyed" + GetDuration(), ErrorExSeverity.INFO);
 #endif
@@ -46,15 +56,66 @@ class MetricZ_CallbackBase : RestCallback
 		return string.Format(", time: %1 ms", (g_Game.GetTime() - m_StartedAt));
 	}
 
+	/**
+	    \brief Remember the endpoint of the attempt being posted.
+	    \param endpoint Index of the client endpoint
+	*/
+	void SetEndpoint(int endpoint)
+	{
+		m_Endpoint = endpoint;
+		m_SentAt = g_Game.GetTime();
+	}
+
+	/**
+	    \brief Count outcome of the last attempt, observe its latency and report it to the endpoint of the client.
+	    \param status Request status (success, error, timeout)
+	*/
+	protected void ReportResult(string status)
+	{
+		MetricZ_HttpStats.IncRequest(m_ReqType, status);
+
+		// not posted, e.g. no usable endpoint
+		if (m_Endpoint < 0)
+			return;
+
+		int ms = g_Game.GetTime() - m_SentAt;
+		MetricZ_HttpStats.ObserveLatency(m_ReqType, status, ms * 0.001);
+
+		if (m_Client)
+			m_Client.OnEndpointResult(m_Endpoint, status, ms);
+	}
+
+	/**
+	    \brief Get transaction ID of the request.
+	    \return \p string Transaction ID or empty string for non-transactional requests
+	*/
+	string GetTxn()
+	{
+		return string.Empty;
+	}
+
 	/**
 	    \brief Handles retry logic with exponential backoff and jitter.
 	    \details Checks config limits. If retries remain, schedules `SendAgain` via CallQueue.
 	             Delay = BaseDelay * 2^(Attempt) * Random(0.75, 1.25).
+	             Requests are not retried while `MetricZ_RestBreaker` is not closed.
 	*/
 	protected void Retry()
 	{
+		if (!MetricZ_RestBreaker.IsClosed()) {
+#ifdef DIAG
+			ErrorEx("MetricZ: callback REST retry skipped, circuit breaker is not closed" + GetDuration(), ErrorExSeverity.INFO);
+#endif
+			MetricZ_RestBreaker.OnFailure(GetTxn());
+			OnGiveUp();
+			OnDone();
+			return;
+		}
+
 		if (m_Attempt >= MetricZ_Config.Get().http.max_retries) {
 			ErrorEx("MetricZ: callback REST all retries failed" + GetDuration(), ErrorExSeverity.ERROR);
+			MetricZ_RestBreaker.OnFailure(GetTxn());
+			OnGiveUp();
 			OnDone();
 			return;
 		}
@@ -81,7 +142,27 @@ class MetricZ_CallbackBase : RestCallback
 		}
 
 		// schedule the retry
-		g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(SendAgain, delay, false);
+		m_RetryScheduled = true;
+		MetricZ_HttpStats.AddScheduledRetries(1);
+		g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(RetryFire, delay, false);
+	}
+
+	/**
+	    \brief Scheduled retry, counts it out of the scheduled retries and calls `SendAgain`.
+	*/
+	private void RetryFire()
+	{
+		m_RetryScheduled = false;
+		MetricZ_HttpStats.AddScheduledRetries(-1);
+
+		SendAgain();
+	}
+
+	/**
+	    \brief Virtual method called when the request is abandoned without success.
+	*/
+	protected void OnGiveUp()
+	{
 	}
 
 	/**
@@ -100,7 +181,7 @@ class MetricZ_CallbackBase : RestCallback
 	protected void OnDone()
 	{
 		if (g_Game)
-			g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).Remove(SendAgain);
+			g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).Remove(RetryFire);
 
 		m_Client = null;
 		delete this;
@@ -112,7 +193,7 @@ class MetricZ_CallbackBase : RestCallback
 	*/
 	override void OnError(int errorCode)
 	{
-		MetricZ_HttpStats.IncRequest(m_ReqType, "error");
+		ReportResult("error");
 		ErrorEx(
 		    string.Format(
 		        "MetricZ: callback REST error %1 %2",
@@ -127,7 +208,7 @@ class MetricZ_CallbackBase : RestCallback
 	*/
 	override void OnTimeout()
 	{
-		MetricZ_HttpStats.IncRequest(m_ReqType, "timeout");
+		ReportResult("timeout");
 		ErrorEx(
 		    string.Format("MetricZ: callback REST timeout %1", GetDuration()),
 		    ErrorExSeverity.WARNING);
@@ -145,7 +226,9 @@ class MetricZ_CallbackBase : RestCallback
 		ErrorEx("MetricZ: callback REST success, size " + dataSize.ToString() + GetDuration(), ErrorExSeverity.INFO);
 #endif
 
-		MetricZ_HttpStats.IncRequest(m_ReqType, "success");
+		ReportResult("success");
+		MetricZ_RestBreaker.OnSuccess();
+		MetricZ_RestSpool.StartReplay();
 		OnDone();
 	}
 }
@@ -12,14 +12,25 @@
 class MetricZ_CallbackCommitMetrics: MetricZ_CallbackBase
 {
 	protected string m_Txn; //!< Transaction ID to commit
+	protected string m_Query; //!< URL query of the commit request
 
 	/**
 	    \brief Sets the transaction ID for this commit request.
 	    \param txn Transaction ID to commit
+	    \param query URL query of the commit request
 	*/
-	void SetTxn(string txn)
+	void SetTxn(string txn, string query = "")
 	{
 		m_Txn = txn;
+		m_Query = query;
+	}
+
+	/**
+	    \brief Get transaction ID to commit.
+	*/
+	override string GetTxn()
+	{
+		return m_Txn;
 	}
 
 	/**
@@ -27,10 +38,33 @@ class MetricZ_CallbackCommitMetrics: MetricZ_CallbackBase
 	*/
 	override protected void SendAgain()
 	{
-		if (m_Client && m_Txn != string.Empty)
-			m_Client.CommitMetrics(m_Txn, this);
+		// transaction was dropped, e.g. by a failover, its chunks are on another endpoint
+		if (m_Client && m_Txn != string.Empty && MetricZ_RestTransactionManager.IsPending(m_Txn))
+			m_Client.CommitMetrics(m_Txn, this, m_Query);
 		else
 			OnDone();
 	}
+
+	/**
+	    \brief Reports committed transaction to the Transaction Manager.
+	    \param data Response data
+	    \param dataSize Response data size
+	*/
+	override void OnSuccess(string data, int dataSize)
+	{
+		MetricZ_RestTransactionManager.OnCommitSuccess(m_Txn, data);
+
+		super.OnSuccess(data, dataSize);
+	}
+
+	/**
+	    \brief Releases the transaction from the window before the callback is destroyed.
+	*/
+	override protected void OnDone()
+	{
+		MetricZ_RestTransactionManager.OnCommitDone(m_Txn);
+
+		super.OnDone();
+	}
 }
 #endif
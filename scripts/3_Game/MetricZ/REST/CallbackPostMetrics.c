@@ -16,19 +16,23 @@ class MetricZ_CallbackPostMetrics : MetricZ_CallbackBase
 	protected string m_Body; //!< Prometheus text payload
 	protected string m_TxnId; //!< Associated transaction ID
 	protected int m_Idx; //!< Sequence number of the chunk
+	protected string m_Session; //!< Series dictionary session, empty for text or JSON payload
 	protected bool m_IsReady; //!< Flag indicating if data is populated
+	protected bool m_IsSent; //!< Request was posted and holds an in-flight slot of the client
 
 	/**
 	    \brief Configures the callback with payload and metadata.
 	    \param body Payload to send
 	    \param txn Transaction ID to associate with the chunk
 	    \param idx Sequence number of the chunk
+	    \param session Series dictionary session of the payload
 	*/
-	void Setup(string body, string txn, int idx)
+	void Setup(string body, string txn, int idx, string session = "")
 	{
 		m_Body = body;
 		m_TxnId = txn;
 		m_Idx = idx;
+		m_Session = session;
 		m_IsReady = true;
 	}
 
@@ -41,6 +45,87 @@ class MetricZ_CallbackPostMetrics : MetricZ_CallbackBase
 		return m_IsReady;
 	}
 
+	/**
+	    \brief Mark the callback as posted, it holds an in-flight slot until OnDone().
+	*/
+	void MarkSent()
+	{
+		m_IsSent = true;
+	}
+
+	/**
+	    \brief Checks if the request was posted at least once.
+	*/
+	bool IsSent()
+	{
+		return m_IsSent;
+	}
+
+	/**
+	    \brief Get payload.
+	*/
+	string GetBody()
+	{
+		return m_Body;
+	}
+
+	/**
+	    \brief Get payload size in bytes.
+	*/
+	int GetBodySize()
+	{
+		return m_Body.Length();
+	}
+
+	/**
+	    \brief Get associated transaction ID.
+	*/
+	override string GetTxn()
+	{
+		return m_TxnId;
+	}
+
+	/**
+	    \brief Get sequence number of the chunk.
+	*/
+	int GetIdx()
+	{
+		return m_Idx;
+	}
+
+	/**
+	    \brief Get series dictionary session of the payload.
+	*/
+	string GetSession()
+	{
+		return m_Session;
+	}
+
+	/**
+	    \brief Stores the chunk in the disk spool for later replay and drops its transaction.
+	    \details The transaction can never complete, later complete transactions are committed without it.
+	*/
+	override protected void OnGiveUp()
+	{
+		MetricZ_RestSpool.Append(m_Body, m_Session, m_TxnId != string.Empty);
+		MetricZ_RestDictionary.OnLost(m_Session);
+
+		if (m_TxnId != string.Empty)
+			MetricZ_RestTransactionManager.Abort(m_TxnId);
+	}
+
+	/**
+	    \brief Destroy a queued chunk of a dropped transaction without posting it.
+	    \details Does not touch the in-flight window of the client.
+	*/
+	void Drop()
+	{
+		MetricZ_RestDictionary.OnLost(m_Session);
+
+		m_Client = null;
+		OnDone();
+	}
+
 	/**
 	    \brief Retries the chunk upload.
 	*/
@@ -51,12 +136,19 @@ class MetricZ_CallbackPostMetrics : MetricZ_CallbackBase
 #ifdef DIAG
 			ErrorEx("MetricZ: Abort retry for stale txn: " + m_TxnId, ErrorExSeverity.INFO);
 #endif
+			MetricZ_RestDictionary.OnLost(m_Session);
+			OnDone();
+			return;
+		}
+
+		// ids of a dropped session are unknown to the endpoint the retry would go to
+		if (m_Session != string.Empty && !MetricZ_RestDictionary.IsCurrent(m_Session)) {
 			OnDone();
 			return;
 		}
 
 		if (m_IsReady && m_Client)
-			m_Client.PostMetrics(m_Body, m_TxnId, m_Idx, this);
+			m_Client.PostMetrics(m_Body, m_TxnId, m_Idx, this, m_Session);
 		else
 			OnDone();
 	}
@@ -68,10 +160,24 @@ class MetricZ_CallbackPostMetrics : MetricZ_CallbackBase
 	*/
 	override void OnSuccess(string data, int dataSize)
 	{
+		if (m_Session != string.Empty)
+			MetricZ_RestDictionary.OnResponse(m_Session, data);
+
 		if (m_TxnId != string.Empty)
 			MetricZ_RestTransactionManager.OnChunkSuccess(m_TxnId, m_Idx);
 
 		super.OnSuccess(data, dataSize);
 	}
+
+	/**
+	    \brief Releases the in-flight slot before the callback is destroyed.
+	*/
+	override protected void OnDone()
+	{
+		if (m_Client)
+			m_Client.OnPostDone(this);
+
+		super.OnDone();
+	}
 }
 #endif
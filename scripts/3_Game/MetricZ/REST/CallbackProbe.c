@@ -0,0 +1,15 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Callback handler for the half-open probe of `MetricZ_RestBreaker`.
+    \details Probe is never retried, the outcome is reported by the base class.
+*/
+class MetricZ_CallbackProbe : MetricZ_CallbackBase
+{
+}
+#endif
@@ -0,0 +1,46 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Callback handler for a chunk replayed from `MetricZ_RestSpool`.
+    \details Replay is never retried, a failed record stops the replay until the next successful request.
+*/
+class MetricZ_CallbackReplay : MetricZ_CallbackBase
+{
+	protected bool m_Success; //!< Backend accepted the record
+
+	/**
+	    \brief Replay gives up at once instead of retrying.
+	*/
+	override protected void Retry()
+	{
+		OnDone();
+	}
+
+	/**
+	    \brief Marks the record as delivered.
+	    \param data Response data
+	    \param dataSize Response data size
+	*/
+	override void OnSuccess(string data, int dataSize)
+	{
+		m_Success = true;
+
+		super.OnSuccess(data, dataSize);
+	}
+
+	/**
+	    \brief Reports the outcome to the spool before the callback is destroyed.
+	*/
+	override protected void OnDone()
+	{
+		MetricZ_RestSpool.OnReplayDone(m_Success);
+
+		super.OnDone();
+	}
+}
+#endif
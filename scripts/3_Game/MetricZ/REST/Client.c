@@ -9,12 +9,24 @@
     \brief REST Client for communicating with the MetricZ backend.
     \details Handles initialization of the RestApi, setting up headers/timeouts,
              and performing POST requests for ingesting chunks and committing transactions.
+             Chunk uploads go through a FIFO queue: at most `http.max_in_flight` requests are
+             outstanding (including retry backoff), queued bodies are bounded by `http.queue_limit_kb`
+             and the oldest transaction is dropped when the budget overflows.
+             A transaction stays on the endpoint it started on: a failover drops open transactions,
+             the dictionary session and the delta base (see `MetricZ_RestTransactionManager.Reset()`),
+             failback to the primary waits until no transaction is open.
 */
 class MetricZ_RestClient : Managed
 {
 	protected static ref MetricZ_RestClient s_Instance; // Singleton instance
 	protected RestApi m_Rest; // Native engine RestApi handle
-	protected RestContext m_Ctx; // Context for the specific base URL
+	protected ref array<ref MetricZ_RestEndpoint> m_Endpoints = new array<ref MetricZ_RestEndpoint>(); //!< Endpoints, primary first
+	protected int m_Active; //!< Index of the endpoint receiving requests
+	protected float m_FailoverAt; //!< Tick time (seconds) of the last failover
+
+	protected ref array<ref MetricZ_CallbackPostMetrics> m_Queue = new array<ref MetricZ_CallbackPostMetrics>(); //!< Chunks waiting for a free slot
+	protected int m_QueuedBytes; //!< Sum of queued body sizes
+	protected int m_InFlight; //!< Chunk requests sent and not done yet
 
 	/**
 	    \brief Singleton accessor.
@@ -32,17 +44,17 @@ class MetricZ_RestClient : Managed
 	}
 
 	/**
-	    \brief Lazy initialization of the REST context.
-	    \details Configures the RestApi with timeouts and headers from the configuration.
-	             This method ensures we don't recreate the context on every request.
+	    \brief Lazy initialization of the REST contexts.
+	    \details Configures the RestApi with timeouts from the configuration and orders
+	             endpoints of `http.urls` by rendezvous hash of the instance ID,
+	             the first one is the primary endpoint of this server.
+	             This method ensures we don't recreate the contexts on every request.
 	*/
 	protected void Init()
 	{
-		if (m_Ctx)
+		if (m_Rest)
 			return;
 
-		string url = MetricZ_Config.Get().http.url;
-
 		if (!MetricZ_Config.Get().http.enabled) {
 			ErrorEx("MetricZ: rest is disabled", ErrorExSeverity.WARNING);
 			return;
@@ -64,53 +76,238 @@ class MetricZ_RestClient : Managed
 		m_Rest.EnableDebug(true);
 #endif
 
-		// Initialize the context for the target URL
-		m_Ctx = m_Rest.GetRestContext(url);
-		if (!m_Ctx) {
-			ErrorEx("MetricZ: failed in GetRestContext", ErrorExSeverity.ERROR);
+		string instanceID = MetricZ_Config.Get().settings.instance_id_resolved;
+		m_Endpoints.Clear();
+
+		foreach (string url : MetricZ_Config.Get().http.urls_resolved) {
+			MetricZ_RestEndpoint endpoint = new MetricZ_RestEndpoint(url);
+			endpoint.Rank(instanceID);
+
+			// insertion by descending rank, list is short
+			int pos = 0;
+			while (pos < m_Endpoints.Count() && m_Endpoints[pos].GetRank() >= endpoint.GetRank())
+				pos++;
+
+			m_Endpoints.InsertAt(endpoint, pos);
+		}
+
+		m_Active = 0;
+
+		if (m_Endpoints.Count() > 0)
+			ErrorEx(string.Format("MetricZ: REST primary endpoint %1 of %2", m_Endpoints[0].GetName(), m_Endpoints.Count()), ErrorExSeverity.INFO);
+	}
+
+	/**
+	    \brief Return to the primary endpoint `http.failback_sec` after a failover.
+	    \details Called before a new transaction starts, only when no transaction is open,
+	             so no transaction is split between two endpoints.
+	*/
+	void CheckFailback()
+	{
+		Init();
+
+		if (m_Active == 0 || m_Endpoints.Count() == 0 || MetricZ_RestTransactionManager.Count() > 0)
 			return;
+
+		if (g_Game.GetTickTime() - m_FailoverAt < MetricZ_Config.Get().http.failback_sec)
+			return;
+
+		m_Active = 0;
+		MetricZ_RestTransactionManager.Reset();
+		ErrorEx("MetricZ: REST failback to primary endpoint " + m_Endpoints[0].GetName(), ErrorExSeverity.INFO);
+	}
+
+	/**
+	    \brief Get context of the active endpoint.
+	    \return \p RestContext or null
+	*/
+	protected RestContext GetContext()
+	{
+		Init();
+
+		if (m_Endpoints.Count() == 0)
+			return null;
+
+		return m_Endpoints[m_Active].GetContext(m_Rest);
+	}
+
+	/**
+	    \brief POST request to the active endpoint.
+	    \param cb Callback handler, remembers the endpoint for failover and metrics
+	    \param url Request path and query
+	    \param body Request body
+	    \return \p bool False if there is no usable endpoint
+	*/
+	protected bool Post(MetricZ_CallbackBase cb, string url, string body)
+	{
+		RestContext ctx = GetContext();
+		if (!ctx) {
+			cb.SetEndpoint(-1);
+			return false;
 		}
 
-		m_Ctx.SetHeader("text/plain");
+		cb.SetEndpoint(m_Active);
+		ctx.POST(cb, url, body);
+
+		return true;
+	}
+
+	/**
+	    \brief Record request outcome of an endpoint and fail over on transport errors.
+	    \param endpoint Index of the endpoint the request was sent to
+	    \param status Request status (success, error, timeout)
+	    \param ms Time since the request was posted, milliseconds
+	*/
+	void OnEndpointResult(int endpoint, string status, int ms)
+	{
+		if (endpoint < 0 || endpoint >= m_Endpoints.Count())
+			return;
+
+		m_Endpoints[endpoint].Observe(status, ms);
+
+		if (status == "success" || endpoint != m_Active || m_Endpoints.Count() < 2)
+			return;
+
+		m_Active = (m_Active + 1) % m_Endpoints.Count();
+		m_FailoverAt = g_Game.GetTickTime();
+
+		ErrorEx(
+		    string.Format("MetricZ: REST %1 on %2, failover to %3", status, m_Endpoints[endpoint].GetName(), m_Endpoints[m_Active].GetName()),
+		    ErrorExSeverity.WARNING);
+
+		// chunks already sent are on the old endpoint, the next scrape goes in full to the new one
+		MetricZ_RestTransactionManager.Reset();
+	}
+
+	/**
+	    \brief Emit per-endpoint metrics.
+	    \param sink MetricZ_SinkBase sink instance
+	*/
+	void FlushEndpoints(MetricZ_SinkBase sink)
+	{
+		MetricZ_RestEndpoint.FlushAll(sink, m_Endpoints, m_Active);
 	}
 
 	/**
 	    \brief Send a single chunk of metrics to the backend.
+	    \details A fresh callback is queued and sent when the in-flight window allows,
+	             a retry of an already sent callback is posted immediately.
 	    \param body The payload (Prometheus formatted metrics)
 	    \param txn The transaction ID to associate this chunk with
 	    \param chunk The sequence number of this chunk (0, 1, 2...)
 	    \param cb The callback handler for success/retry logic
+	    \param session Series dictionary session for `format=dict` payload, empty for text or JSON
 	*/
-	void PostMetrics(string body, string txn, int chunk, MetricZ_CallbackPostMetrics cb)
+	void PostMetrics(string body, string txn, int chunk, MetricZ_CallbackPostMetrics cb, string session = "")
 	{
 		if (!cb || body == string.Empty)
 			return;
 
-		Init();
+		if (cb.IsReady()) {
+			Send(cb);
+			return;
+		}
+
+		cb.Setup(body, txn, chunk, session);
+
+		m_Queue.Insert(cb);
+		m_QueuedBytes += body.Length();
+
+		TrimQueue();
+		Pump();
+	}
+
+	/**
+	    \brief Release the window slot of a finished chunk request and send the next queued one.
+	    \param cb Finished callback
+	*/
+	void OnPostDone(MetricZ_CallbackPostMetrics cb)
+	{
+		if (cb && cb.IsSent())
+			m_InFlight = Math.Max(m_InFlight - 1, 0);
+
+		Pump();
+	}
+
+	/**
+	    \brief Send queued chunks while the in-flight window has free slots.
+	*/
+	protected void Pump()
+	{
+		int maxInFlight = MetricZ_Config.Get().http.max_in_flight;
+
+		while (m_Queue.Count() > 0 && m_InFlight < maxInFlight) {
+			MetricZ_CallbackPostMetrics cb = m_Queue[0];
+			m_Queue.RemoveOrdered(0);
+			m_QueuedBytes -= cb.GetBodySize();
+
+			// transaction was dropped by a failover while the chunk waited
+			string txn = cb.GetTxn();
+			if (txn != string.Empty && !MetricZ_RestTransactionManager.IsActive(txn)) {
+				cb.Drop();
+				continue;
+			}
+
+			m_InFlight++;
+			Send(cb);
+		}
+
+		MetricZ_HttpStats.SetQueue(m_InFlight, m_QueuedBytes);
+	}
+
+	/**
+	    \brief Drop queued chunks of the oldest transactions until the queue fits the byte budget.
+	*/
+	protected void TrimQueue()
+	{
+		int limit = MetricZ_Config.Get().http.queue_limit_kb * 1024;
+
+		while (m_QueuedBytes > limit && m_Queue.Count() > 0) {
+			string txn = m_Queue[0].GetTxn();
+			int dropped = 0;
+
+			for (int i = m_Queue.Count() - 1; i >= 0; i--) {
+				if (i > 0 && (txn == string.Empty || m_Queue[i].GetTxn() != txn))
+					continue;
+
+				m_QueuedBytes -= m_Queue[i].GetBodySize();
+				MetricZ_RestDictionary.OnLost(m_Queue[i].GetSession());
+				m_Queue.RemoveOrdered(i);
+				dropped++;
+			}
+
+			MetricZ_RestTransactionManager.Abort(txn);
+			MetricZ_HttpStats.AddDropped(dropped);
+			ErrorEx(string.Format("MetricZ: REST queue over budget, dropped %1 chunk(s) of txn %2", dropped, txn), ErrorExSeverity.WARNING);
+		}
+	}
+
+	/**
+	    \brief Build URL and POST a configured chunk callback.
+	    \param cb Callback with body and metadata set by Setup()
+	*/
+	protected void Send(MetricZ_CallbackPostMetrics cb)
+	{
+		string body = cb.GetBody();
+		string txn = cb.GetTxn();
+		int chunk = cb.GetIdx();
+		string session = cb.GetSession();
 
 		// Construct URL: `/api/v1/ingest/<instance_id>/<txn_id>/<seq_id>`
 		// The backend uses <seq_id> to reassemble chunks in the correct order.
 		string url;
 		string instanceID = MetricZ_Config.Get().settings.instance_id_resolved;
 
-		if (txn == string.Empty) {
-			if (MetricZ_Config.Get().http.serialized)
-				url = string.Format("/api/v1/ingest/%1?format=json", instanceID);
-			else
-				url = string.Format("/api/v1/ingest/%1", instanceID);
-		} else {
-			if (MetricZ_Config.Get().http.serialized)
-				url = string.Format("/api/v1/ingest/%1/%2/%3", instanceID, txn, chunk);
-			else
-				url = string.Format("/api/v1/ingest/%1/%2/%3?format=json", instanceID, txn, chunk);
-		}
+		if (txn == string.Empty)
+			url = string.Format("/api/v1/ingest/%1%2", instanceID, FormatQuery(session));
+		else
+			url = string.Format("/api/v1/ingest/%1/%2/%3%4", instanceID, txn, chunk, FormatQuery(session));
 
-		// If callback is fresh (not a retry), configure it with current data
-		if (!cb.IsReady())
-			cb.Setup(body, txn, chunk);
+		cb.MarkSent();
 
 		MetricZ_HttpStats.AddBytes(body.Length());
-		m_Ctx.POST(cb, url, body);
+		if (!Post(cb, url, body))
+			cb.OnError(ERestResultState.EREST_ERROR);
 
 #ifdef DIAG
 		ErrorEx("MetricZ: metrics POST " + url, ErrorExSeverity.INFO);
@@ -121,25 +318,103 @@ class MetricZ_RestClient : Managed
 	    \brief Signal the backend that all chunks for a transaction have been sent.
 	    \param txn The transaction ID to commit
 	    \param cb Callback handler
+	    \param query Optional URL query, e.g. delta sequence `?mode=delta&seq=N&base=M`
 	*/
-	void CommitMetrics(string txn, MetricZ_CallbackCommitMetrics cb)
+	void CommitMetrics(string txn, MetricZ_CallbackCommitMetrics cb, string query = "")
 	{
 		if (txn == string.Empty || !cb)
 			return;
 
-		Init();
-
 		string url = string.Format(
-		                 "/api/v1/commit/%1/%2",
+		                 "/api/v1/commit/%1/%2%3",
 		                 MetricZ_Config.Get().settings.instance_id_resolved,
-		                 txn);
+		                 txn,
+		                 query);
 
-		cb.SetTxn(txn);
-		m_Ctx.POST(cb, url, string.Empty);
+		cb.SetTxn(txn, query);
+		if (!Post(cb, url, string.Empty))
+			cb.OnError(ERestResultState.EREST_ERROR);
 
 #ifdef DIAG
 		ErrorEx("MetricZ: commit POST " + url, ErrorExSeverity.INFO);
 #endif
 	}
+
+	/**
+	    \brief Post the half-open probe of `MetricZ_RestBreaker`.
+	    \details One comment line as chunk 0 of a throwaway transaction that is never committed,
+	             so the published metrics of the instance are not touched.
+	    \param cb Callback handler
+	*/
+	void PostProbe(MetricZ_CallbackProbe cb)
+	{
+		if (!cb)
+			return;
+
+		int uuid[4];
+		UUIDApi.Generate(uuid);
+
+		string url = string.Format(
+		                 "/api/v1/ingest/%1/%2/0",
+		                 MetricZ_Config.Get().settings.instance_id_resolved,
+		                 UUIDApi.FormatString(uuid));
+
+		if (!Post(cb, url, "# MetricZ probe\n"))
+			cb.OnError(ERestResultState.EREST_ERROR);
+
+#ifdef DIAG
+		ErrorEx("MetricZ: probe POST " + url, ErrorExSeverity.INFO);
+#endif
+	}
+
+	/**
+	    \brief Post a chunk replayed from `MetricZ_RestSpool`.
+	    \details Sent outside of transactions with `replay=<epoch>` query, so the backend
+	             can store it as historical data instead of the current state.
+	             `partial=1` marks a chunk of a transaction, not a whole scrape.
+	    \param body Chunk body
+	    \param epoch UTC epoch seconds when the chunk was spooled
+	    \param json Body is a serialized JSON array
+	    \param partial Chunk is a part of a scrape
+	    \param cb Callback handler
+	*/
+	void PostReplay(string body, string epoch, bool json, bool partial, MetricZ_CallbackReplay cb)
+	{
+		if (!cb || body == string.Empty)
+			return;
+
+		string query = "?replay=" + epoch;
+		if (json)
+			query += "&format=json";
+
+		if (partial)
+			query += "&partial=1";
+
+		string url = string.Format("/api/v1/ingest/%1%2", MetricZ_Config.Get().settings.instance_id_resolved, query);
+
+		MetricZ_HttpStats.AddBytes(body.Length());
+		if (!Post(cb, url, body))
+			cb.OnError(ERestResultState.EREST_ERROR);
+
+#ifdef DIAG
+		ErrorEx("MetricZ: replay POST " + url, ErrorExSeverity.INFO);
+#endif
+	}
+
+	/**
+	    \brief Build payload format query of the ingest URL.
+	    \param session Series dictionary session, selects `format=dict` if not empty
+	    \return \p string Query with leading `?` or empty string for Prometheus text
+	*/
+	protected string FormatQuery(string session)
+	{
+		if (session != string.Empty)
+			return "?format=dict&session=" + session;
+
+		if (MetricZ_Config.Get().http.serialized)
+			return "?format=json";
+
+		return string.Empty;
+	}
 }
 #endif
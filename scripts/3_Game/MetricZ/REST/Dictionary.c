@@ -0,0 +1,174 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Series dictionary of the `format=dict` REST payload.
+    \details Every distinct series (`name{labels}` or a HELP/TYPE line) gets an integer id once per session.
+             The first line using an id carries its table entry, later lines send only `id value`:
+               - `@<id> <series>` table entry, followed by the sample line in the same chunk
+               - `<id> <value>` sample
+               - `<id>` HELP/TYPE line without value
+               - `-<id>` series is gone (delta uploads only)
+             The session id is sent with every request. When the backend answers with `resync`
+             (e.g. it was restarted and lost the table) a new session starts with the next transaction
+             and all table entries are sent again.
+             Ids are registered when a line is encoded, so a chunk that never reaches the backend
+             (dropped from the queue, given up, or its transaction evicted) also starts a new session.
+*/
+class MetricZ_RestDictionary
+{
+	static const string RESYNC = "resync"; //!< Backend response body asking for the full table
+
+	protected static string s_Session; //!< Current session id
+	protected static bool s_ResetPending; //!< Start new session on next BeginCycle()
+	protected static ref map<string, int> s_Ids = new map<string, int>(); //!< Series -> id
+
+	/**
+	    \brief Apply pending session reset, call before the first line of a transaction.
+	    \details Keeps the session constant within one transaction.
+	*/
+	static void BeginCycle()
+	{
+		if (s_Session == string.Empty || s_ResetPending || s_Ids.Count() >= MetricZ_Constants.MAX_DICTIONARY_SERIES)
+			Reset();
+	}
+
+	/**
+	    \brief Get current session id.
+	*/
+	static string GetSession()
+	{
+		return s_Session;
+	}
+
+	/**
+	    \brief Check if a chunk encoded with session can still be decoded by the backend.
+	    \param session Session id the chunk was encoded with
+	*/
+	static bool IsCurrent(string session)
+	{
+		return session == s_Session && !s_ResetPending;
+	}
+
+	/**
+	    \brief Number of series in the table.
+	*/
+	static int Count()
+	{
+		return s_Ids.Count();
+	}
+
+	/**
+	    \brief Handle the backend response of a dictionary chunk.
+	    \param session Session id the chunk was encoded with
+	    \param data Response body
+	*/
+	static void OnResponse(string session, string data)
+	{
+		if (session == string.Empty || session != s_Session)
+			return;
+
+		if (!data.Contains(RESYNC))
+			return;
+
+		s_ResetPending = true;
+		ErrorEx("MetricZ: backend requested series table resync", ErrorExSeverity.WARNING);
+	}
+
+	/**
+	    \brief Handle a chunk that will never reach the backend.
+	    \details Table entries of the chunk are lost, the next transaction starts a new session.
+	    \param session Session id the chunk was encoded with
+	*/
+	static void OnLost(string session)
+	{
+		if (session == string.Empty || session != s_Session || s_ResetPending)
+			return;
+
+		s_ResetPending = true;
+		ErrorEx("MetricZ: dictionary chunk lost, series table resync", ErrorExSeverity.WARNING);
+	}
+
+	/**
+	    \brief Split Prometheus text line into series and value.
+	    \param line Prometheus text line
+	    \param[out] series `name{labels}` or the whole HELP/TYPE line
+	    \param[out] value Sample value, empty for HELP/TYPE lines
+	*/
+	static void SplitLine(string line, out string series, out string value)
+	{
+		series = line;
+		value = string.Empty;
+
+		if (line.IndexOf("#") == 0)
+			return;
+
+		int sp = line.LastIndexOf(" ");
+		if (sp > 0) {
+			series = line.Substring(0, sp);
+			value = line.Substring(sp + 1, line.Length() - sp - 1);
+		}
+	}
+
+	/**
+	    \brief Get id of a known series.
+	    \return \p int Id or -1 if the series has no id in this session
+	*/
+	static int Find(string series)
+	{
+		int id;
+		if (s_Ids.Find(series, id))
+			return id;
+
+		return -1;
+	}
+
+	/**
+	    \brief Encode metric line split by SplitLine().
+	    \param series Series text
+	    \param value Sample value, empty for HELP/TYPE lines
+	    \return \p string Encoded line, prefixed with the table entry line for a new series
+	*/
+	static string Encode(string series, string value)
+	{
+		int id;
+		string sample;
+		if (s_Ids.Find(series, id)) {
+			sample = id.ToString();
+			if (value != string.Empty)
+				sample += " " + value;
+
+			return sample;
+		}
+
+		id = s_Ids.Count();
+		s_Ids.Insert(series, id);
+
+		sample = id.ToString();
+		if (value != string.Empty)
+			sample += " " + value;
+
+		return string.Format("@%1 %2\n%3", id, series, sample);
+	}
+
+	/**
+	    \brief Drop the table and start a new session.
+	*/
+	protected static void Reset()
+	{
+		int uuid[4];
+		UUIDApi.Generate(uuid);
+		s_Session = UUIDApi.FormatString(uuid);
+		s_Ids.Clear();
+		s_ResetPending = false;
+
+#ifdef DIAG
+		ErrorEx("MetricZ: series dictionary session " + s_Session, ErrorExSeverity.INFO);
+#endif
+	}
+}
+#endif
@@ -0,0 +1,169 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief One metricz-exporter endpoint of `MetricZ_RestClient`.
+    \details Holds the RestContext of the base URL and per-endpoint request metrics.
+             The `endpoint` label is the URL without credentials.
+*/
+class MetricZ_RestEndpoint
+{
+	protected static ref MetricZ_LabelSchema s_LabelSchema = new MetricZ_LabelSchema("endpoint");
+
+	protected string m_Url; //!< Base URL with credentials
+	protected string m_Name; //!< Base URL without credentials
+	protected RestContext m_Ctx; //!< Context of the base URL
+	protected int m_Rank; //!< Rendezvous hash score of this endpoint for the instance
+
+	// Metrics
+	protected ref MetricZ_MetricInt m_Active = new MetricZ_MetricInt(
+	    "http_endpoint_active",
+	    "Endpoint currently used for HTTP export (1 active, 0 standby)",
+	    MetricZ_MetricType.GAUGE);
+	protected ref MetricZ_MetricVector m_Requests = MetricZ_MetricVector.Create(
+	    "http_endpoint_requests",
+	    "Total HTTP requests by endpoint and status",
+	    MetricZ_MetricType.COUNTER,
+	    "endpoint",
+	    "status");
+	protected ref MetricZ_MetricHistogram m_Latency = new MetricZ_MetricHistogram(
+	    "http_endpoint_latency_seconds",
+	    "HTTP request latency by endpoint, seconds",
+	    MetricZ_MetricType.HISTOGRAM);
+
+	/**
+	    \brief Constructor.
+	    \param url Base URL, credentials may be included
+	*/
+	void MetricZ_RestEndpoint(string url)
+	{
+		m_Url = url;
+		m_Name = StripCredentials(url);
+
+		// 5ms .. ~20s
+		m_Latency.SetBounds(MetricZ_MetricHistogram.ExponentialBounds(0.005, 2, 13));
+		m_Latency.SetLabels(s_LabelSchema.Render(m_Name));
+		m_Active.SetLabels(s_LabelSchema.Render(m_Name));
+	}
+
+	/**
+	    \brief Get base URL with credentials.
+	*/
+	string GetUrl()
+	{
+		return m_Url;
+	}
+
+	/**
+	    \brief Get base URL without credentials.
+	*/
+	string GetName()
+	{
+		return m_Name;
+	}
+
+	/**
+	    \brief Get or create the RestContext of this endpoint.
+	    \param rest Native RestApi manager
+	    \return \p RestContext or null
+	*/
+	RestContext GetContext(RestApi rest)
+	{
+		if (m_Ctx || !rest)
+			return m_Ctx;
+
+		m_Ctx = rest.GetRestContext(m_Url);
+		if (!m_Ctx) {
+			ErrorEx("MetricZ: failed in GetRestContext for " + m_Name, ErrorExSeverity.ERROR);
+			return null;
+		}
+
+		m_Ctx.SetHeader("text/plain");
+
+		return m_Ctx;
+	}
+
+	/**
+	    \brief Compute rendezvous hash score for an instance.
+	    \details Every instance orders endpoints by descending score, the first one is its primary.
+	             Adding or removing an endpoint moves only the instances whose best score changed.
+	    \param instanceID Resolved instance ID
+	*/
+	void Rank(string instanceID)
+	{
+		m_Rank = (instanceID + "|" + m_Name).Hash();
+	}
+
+	/**
+	    \brief Get rendezvous hash score.
+	*/
+	int GetRank()
+	{
+		return m_Rank;
+	}
+
+	/**
+	    \brief Record request outcome.
+	    \param status Request status (success, error, timeout)
+	    \param ms Time since the request was posted, milliseconds
+	*/
+	void Observe(string status, int ms)
+	{
+		m_Requests.Inc(m_Requests.Slot(m_Name, status));
+		m_Latency.Observe(ms * 0.001);
+	}
+
+	/**
+	    \brief Emit metrics of endpoints as three families.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param endpoints Endpoints to write
+	    \param active Index of the active endpoint
+	*/
+	static void FlushAll(MetricZ_SinkBase sink, array<ref MetricZ_RestEndpoint> endpoints, int active)
+	{
+		int count = endpoints.Count();
+		if (!sink || count == 0)
+			return;
+
+		endpoints[0].m_Active.WriteHeaders(sink);
+		for (int i = 0; i < count; i++) {
+			if (i == active)
+				endpoints[i].m_Active.Set(1);
+			else
+				endpoints[i].m_Active.Set(0);
+
+			endpoints[i].m_Active.Flush(sink);
+		}
+
+		endpoints[0].m_Requests.WriteHeaders(sink);
+		foreach (MetricZ_RestEndpoint endpoint : endpoints)
+			endpoint.m_Requests.Flush(sink);
+
+		endpoints[0].m_Latency.WriteHeaders(sink);
+		foreach (MetricZ_RestEndpoint e : endpoints)
+			e.m_Latency.Flush(sink);
+	}
+
+	/**
+	    \brief Remove `user:password@` from URL.
+	    \param url URL
+	    \return \p string URL without credentials
+	*/
+	protected static string StripCredentials(string url)
+	{
+		int at = url.IndexOf("@");
+		if (at < 0)
+			return url;
+
+		int schema = url.IndexOf("://");
+		if (schema < 0)
+			return url.Substring(at + 1, url.Length() - at - 1);
+
+		return url.Substring(0, schema + 3) + url.Substring(at + 1, url.Length() - at - 1);
+	}
+}
+#endif
@@ -7,23 +7,31 @@
 #ifdef SERVER
 /**
     \brief HTTP transport statistics aggregator
+    \details Besides request counters keeps request latency histograms by type and outcome,
+             end-to-end transaction latency and gauges of pending callbacks and scheduled retries,
+             which show when the exporter link is the bottleneck.
 */
 class MetricZ_HttpStats
 {
 	// Stats
 	protected static int s_TotalRetries; //!< Total number of retries
 	protected static int s_TotalBytes; //!< Total number of bytes sent
-
-	// Caches
-	protected static ref map<string, int> s_Lookup = new map<string, int>(); //!< map `type:status` -> index in arrays
-	protected static ref array<string> s_CacheLabels = new array<string>(); //!< label cache
-	protected static ref array<int> s_Counts = new array<int>(); //!< actual counters matched by index
+	protected static int s_TotalDropped; //!< Total number of chunks dropped by the queue budget
+	protected static int s_InFlight; //!< Chunk requests in flight
+	protected static int s_QueuedBytes; //!< Bytes of chunks waiting in the queue
+	protected static int s_Callbacks; //!< Callbacks alive (in flight, waiting for retry or queued)
+	protected static int s_ScheduledRetries; //!< Retries waiting for their backoff delay
+	protected static ref map<string, ref MetricZ_MetricHistogram> s_Latency = new map<string, ref MetricZ_MetricHistogram>(); //!< "type|status" -> request latency
+	protected static ref MetricZ_LabelSchema s_LatencySchema = new MetricZ_LabelSchema("type,status");
+	protected static bool s_TxnBounds; //!< Bounds of s_MetricTxnLatency are set
 
 	// Metrics
-	protected static ref MetricZ_MetricInt s_MetricRequests = new MetricZ_MetricInt(
+	protected static ref MetricZ_MetricVector s_MetricRequests = MetricZ_MetricVector.Create(
 	    "http_requests",
 	    "Total HTTP requests by type and status",
-	    MetricZ_MetricType.COUNTER);
+	    MetricZ_MetricType.COUNTER,
+	    "type",
+	    "status");
 	protected static ref MetricZ_MetricInt s_MetricRetries = new MetricZ_MetricInt(
 	    "http_retries",
 	    "Total HTTP callback retries",
@@ -32,10 +40,34 @@ class MetricZ_HttpStats
 	    "http_sent_bytes",
 	    "Total bytes sent via HTTP body",
 	    MetricZ_MetricType.COUNTER);
+	protected static ref MetricZ_MetricInt s_MetricDropped = new MetricZ_MetricInt(
+	    "http_dropped_chunks",
+	    "Total chunks dropped because the HTTP queue exceeded its byte budget",
+	    MetricZ_MetricType.COUNTER);
+	protected static ref MetricZ_MetricInt s_MetricInFlight = new MetricZ_MetricInt(
+	    "http_in_flight_requests",
+	    "HTTP chunk requests sent and not finished yet",
+	    MetricZ_MetricType.GAUGE);
+	protected static ref MetricZ_MetricInt s_MetricQueuedBytes = new MetricZ_MetricInt(
+	    "http_queued_bytes",
+	    "Bytes of HTTP chunks waiting for a free request slot",
+	    MetricZ_MetricType.GAUGE);
+	protected static ref MetricZ_MetricInt s_MetricCallbacks = new MetricZ_MetricInt(
+	    "http_pending_callbacks",
+	    "HTTP callbacks alive: in flight, waiting for retry or queued",
+	    MetricZ_MetricType.GAUGE);
+	protected static ref MetricZ_MetricInt s_MetricScheduledRetries = new MetricZ_MetricInt(
+	    "http_scheduled_retries",
+	    "HTTP retries waiting for their backoff delay",
+	    MetricZ_MetricType.GAUGE);
+	protected static ref MetricZ_MetricHistogram s_MetricTxnLatency = new MetricZ_MetricHistogram(
+	    "http_transaction_latency_seconds",
+	    "Time from transaction start to commit success, seconds",
+	    MetricZ_MetricType.HISTOGRAM);
 
 	/**
 	    \brief Increment request counter.
-	    \details Handles full label construction once per new type/status pair.
+	    \details Labels are rendered once per new type/status pair.
 	    \param type Request type
 	    \param status Request status
 	*/
@@ -44,22 +76,7 @@ class MetricZ_HttpStats
 		if (!MetricZ_Config.IsLoaded() || MetricZ_Config.Get().disabled_metrics.http)
 			return;
 
-		string key = string.Format("%1:%2", type, status);
-		int idx;
-
-		if (s_Lookup.Find(key, idx)) {
-			s_Counts.Set(idx, s_Counts.Get(idx) + 1);
-			return;
-		}
-
-		map<string, string> labelsMap = new map<string, string>();
-		labelsMap.Insert("type", type);
-		labelsMap.Insert("status", status);
-		string labels = MetricZ_LabelUtils.MakeLabels(labelsMap);
-
-		s_Lookup.Insert(key, s_Counts.Count());
-		s_CacheLabels.Insert(labels);
-		s_Counts.Insert(1);
+		s_MetricRequests.Inc(s_MetricRequests.Slot(type, status));
 	}
 
 	/**
@@ -85,6 +102,90 @@ class MetricZ_HttpStats
 		s_TotalBytes += bytes;
 	}
 
+	/**
+	    \brief Add to total dropped chunks.
+	    \param count Number of dropped chunks
+	*/
+	static void AddDropped(int count)
+	{
+		if (count > 0)
+			s_TotalDropped += count;
+	}
+
+	/**
+	    \brief Update request queue state.
+	    \param inFlight Chunk requests in flight
+	    \param queuedBytes Bytes waiting in the queue
+	*/
+	static void SetQueue(int inFlight, int queuedBytes)
+	{
+		s_InFlight = inFlight;
+		s_QueuedBytes = queuedBytes;
+	}
+
+	/**
+	    \brief Count alive callbacks.
+	    \param delta +1 on create, -1 on destroy
+	*/
+	static void AddCallbacks(int delta)
+	{
+		s_Callbacks = Math.Max(s_Callbacks + delta, 0);
+	}
+
+	/**
+	    \brief Count retries waiting for their backoff delay.
+	    \param delta +1 on schedule, -1 on fire or cancel
+	*/
+	static void AddScheduledRetries(int delta)
+	{
+		s_ScheduledRetries = Math.Max(s_ScheduledRetries + delta, 0);
+	}
+
+	/**
+	    \brief Record latency of one request attempt.
+	    \details Histogram per type/status pair is created on first use.
+	    \param type Request type
+	    \param status Request status (success, error, timeout)
+	    \param seconds Time from POST to response
+	*/
+	static void ObserveLatency(string type, string status, float seconds)
+	{
+		if (!MetricZ_Config.IsLoaded() || MetricZ_Config.Get().disabled_metrics.http)
+			return;
+
+		string key = type + "|" + status;
+
+		MetricZ_MetricHistogram hist;
+		if (!s_Latency.Find(key, hist)) {
+			hist = new MetricZ_MetricHistogram(
+			    "http_request_latency_seconds",
+			    "HTTP request latency by type and outcome, seconds",
+			    MetricZ_MetricType.HISTOGRAM);
+
+			// 5ms .. ~20s
+			hist.SetBounds(MetricZ_MetricHistogram.ExponentialBounds(0.005, 2, 13));
+			hist.SetLabels(s_LatencySchema.Render(type, status));
+			s_Latency.Insert(key, hist);
+		}
+
+		hist.Observe(seconds);
+	}
+
+	/**
+	    \brief Record end-to-end latency of a committed transaction.
+	    \param seconds Time from transaction start to commit success
+	*/
+	static void ObserveTransaction(float seconds)
+	{
+		// 50ms .. ~100s
+		if (!s_TxnBounds) {
+			s_MetricTxnLatency.SetBounds(MetricZ_MetricHistogram.ExponentialBounds(0.05, 2, 12));
+			s_TxnBounds = true;
+		}
+
+		s_MetricTxnLatency.Observe(seconds);
+	}
+
 	/**
 	    \brief Emit metrics to sink.
 	*/
@@ -99,15 +200,41 @@ class MetricZ_HttpStats
 		s_MetricBytes.Set(s_TotalBytes);
 		s_MetricBytes.FlushWithHead(sink);
 
-		int count = s_Counts.Count();
-		if (count > 0) {
-			s_MetricRequests.WriteHeaders(sink);
+		s_MetricDropped.Set(s_TotalDropped);
+		s_MetricDropped.FlushWithHead(sink);
+
+		s_MetricInFlight.Set(s_InFlight);
+		s_MetricInFlight.FlushWithHead(sink);
+
+		s_MetricQueuedBytes.Set(s_QueuedBytes);
+		s_MetricQueuedBytes.FlushWithHead(sink);
 
-			for (int i = 0; i < count; ++i) {
-				s_MetricRequests.Set(s_Counts.Get(i));
-				s_MetricRequests.Flush(sink, s_CacheLabels.Get(i));
-			}
+		s_MetricRequests.FlushWithHead(sink);
+
+		s_MetricCallbacks.Set(s_Callbacks);
+		s_MetricCallbacks.FlushWithHead(sink);
+
+		s_MetricScheduledRetries.Set(s_ScheduledRetries);
+		s_MetricScheduledRetries.FlushWithHead(sink);
+
+		bool head = true;
+		foreach (string key, MetricZ_MetricHistogram hist : s_Latency) {
+			if (head)
+				hist.WriteHeaders(sink);
+
+			head = false;
+			hist.Flush(sink);
 		}
+
+		if (s_MetricTxnLatency.GetCount() > 0)
+			s_MetricTxnLatency.FlushWithHead(sink);
+
+		MetricZ_RestClient client = MetricZ_RestClient.Get();
+		if (client)
+			client.FlushEndpoints(sink);
+
+		MetricZ_RestBreaker.Flush(sink);
+		MetricZ_RestSpool.Flush(sink);
 	}
 }
 #endif
@@ -0,0 +1,436 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Disk spool of REST chunks that failed all retries.
+    \details Failed chunks are collected in memory and written as segment files of about
+             `MetricZ_Constants.SPOOL_SEGMENT_SIZE` bytes (one write per segment) into
+             `MetricZ_Constants.SPOOL_DIR`. Segment names start with the UTC epoch, so name order is time order.
+             The total size is capped by `http.spool_limit_mb`, the oldest segments are deleted first.
+             Once the backend accepts requests again, records are replayed one at a time,
+             one per `http.spool_replay_interval_ms`, from the call queue.
+             Segment file format, one record per chunk:
+               - `@chunk <epoch> <text|json> <full|part> <length>` header line, length of the body in bytes
+               - chunk body and a newline
+             Records without length (older versions) end at the next header line.
+             A chunk of a transaction is only a part of its scrape, the other chunks may have been
+             delivered or lost, so it is marked `part` and replayed with `partial=1`.
+             A failed replay keeps the position in the segment, replayed records are cut from the file
+             when the replay stops, so they are not sent again after a restart.
+             Dictionary and delta chunks are not spooled, they are meaningful only within their session or base.
+*/
+class MetricZ_RestSpool
+{
+	static const string HEADER = "@chunk "; //!< Record header prefix
+
+	protected static ref MetricZ_TextBuilder s_Buffer = new MetricZ_TextBuilder(); //!< Records not written yet
+	protected static int s_BufferBytes; //!< Size of s_Buffer
+	protected static bool s_WriteScheduled; //!< Delayed WriteSegment() is queued
+	protected static int s_SegmentSeq; //!< Sequence of segments written in this session
+	protected static ref array<string> s_Files; //!< Segment files, oldest first, null until scanned
+
+	// Replay
+	protected static bool s_Replaying; //!< Replay loop is running
+	protected static string s_ReplayFile; //!< Segment being replayed
+	protected static string s_ReplayData; //!< Content of s_ReplayFile
+	protected static int s_ReplayPos; //!< Offset of the next record in s_ReplayData
+	protected static int s_ReplayStart; //!< Offset of the record in flight in s_ReplayData
+	protected static bool s_ReplayLast; //!< Record in flight is the last one of s_ReplayFile
+
+	// Stats
+	protected static int s_TotalSpooled; //!< Total chunks written to spool
+	protected static int s_TotalReplayed; //!< Total chunks replayed
+	protected static int s_TotalDropped; //!< Total segments deleted by size cap
+
+	// Metrics
+	protected static ref MetricZ_MetricInt s_MetricSpooled = new MetricZ_MetricInt(
+	    "http_spooled_chunks",
+	    "Total failed HTTP chunks written to the disk spool",
+	    MetricZ_MetricType.COUNTER);
+	protected static ref MetricZ_MetricInt s_MetricReplayed = new MetricZ_MetricInt(
+	    "http_spool_replayed_chunks",
+	    "Total spooled HTTP chunks replayed to the backend",
+	    MetricZ_MetricType.COUNTER);
+	protected static ref MetricZ_MetricInt s_MetricDropped = new MetricZ_MetricInt(
+	    "http_spool_dropped_segments",
+	    "Total spool segments deleted because the spool exceeded its size limit",
+	    MetricZ_MetricType.COUNTER);
+	protected static ref MetricZ_MetricInt s_MetricSegments = new MetricZ_MetricInt(
+	    "http_spool_segments",
+	    "Spool segment files waiting for replay",
+	    MetricZ_MetricType.GAUGE);
+
+	/**
+	    \brief Check if the spool is enabled in config.
+	*/
+	static bool IsEnabled()
+	{
+		return MetricZ_Config.IsLoaded() && MetricZ_Config.Get().http.spool;
+	}
+
+	/**
+	    \brief Store a chunk that failed all retries.
+	    \param body Chunk body
+	    \param session Series dictionary session of the chunk, dictionary chunks are skipped
+	    \param partial Chunk is a part of a transaction, not a whole scrape
+	*/
+	static void Append(string body, string session = "", bool partial = false)
+	{
+		if (!IsEnabled() || body == string.Empty || session != string.Empty || MetricZ_Config.Get().http.delta)
+			return;
+
+		string format = "text";
+		if (MetricZ_Config.Get().http.serialized)
+			format = "json";
+
+		int last = body.Length() - 1;
+		if (body.Get(last) == "\n")
+			body = body.Substring(0, last);
+
+		string scope = "full";
+		if (partial)
+			scope = "part";
+
+		string header = string.Format("%1%2 %3 %4 %5", HEADER, MetricZ_Time.EpochSecondsUTC(), format, scope, body.Length());
+		s_Buffer.Append(header);
+		s_Buffer.Append(body);
+		s_BufferBytes += header.Length() + body.Length() + 2;
+		s_TotalSpooled++;
+
+		if (s_BufferBytes >= MetricZ_Constants.SPOOL_SEGMENT_SIZE) {
+			WriteSegment();
+			return;
+		}
+
+		if (!s_WriteScheduled && g_Game) {
+			s_WriteScheduled = true;
+			g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(WriteSegment, MetricZ_Constants.SPOOL_WRITE_DELAY, false);
+		}
+	}
+
+	/**
+	    \brief Write buffered records as a new segment file and apply the size cap.
+	*/
+	static void WriteSegment()
+	{
+		if (s_WriteScheduled && g_Game)
+			g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).Remove(WriteSegment);
+
+		s_WriteScheduled = false;
+
+		if (s_Buffer.Count() == 0)
+			return;
+
+		Scan();
+
+		if (!FileExist(MetricZ_Constants.SPOOL_DIR))
+			MakeDirectory(MetricZ_Constants.SPOOL_DIR);
+
+		s_SegmentSeq++;
+		string file = string.Format(
+		                  "%1%2_%3.spool",
+		                  MetricZ_Constants.SPOOL_DIR,
+		                  MetricZ_Time.EpochSecondsUTC().ToStringLen(10),
+		                  s_SegmentSeq.ToStringLen(6));
+
+		FileHandle fh = OpenFile(file, FileMode.WRITE);
+		if (fh == 0) {
+			ErrorEx("MetricZ: fail open spool file: " + file, ErrorExSeverity.ERROR);
+		} else {
+			FPrint(fh, s_Buffer.Join());
+			CloseFile(fh);
+			s_Files.Insert(file);
+		}
+
+		s_Buffer.Clear();
+		s_BufferBytes = 0;
+
+		int maxSegments = Math.Max(MetricZ_Config.Get().http.spool_limit_mb * 1048576 / MetricZ_Constants.SPOOL_SEGMENT_SIZE, 1);
+		while (s_Files.Count() > maxSegments) {
+			ErrorEx("MetricZ: spool is full, drop " + s_Files[0], ErrorExSeverity.WARNING);
+
+			// segment being replayed is gone, continue with the next one
+			if (s_Files[0] == s_ReplayFile)
+				CloseReplay();
+
+			DeleteFile(s_Files[0]);
+			s_Files.RemoveOrdered(0);
+			s_TotalDropped++;
+		}
+	}
+
+	/**
+	    \brief Start paced replay if the spool holds data.
+	    \details Called after every successful request, cheap when the spool is empty or replay is running.
+	*/
+	static void StartReplay()
+	{
+		if (s_Replaying || !IsEnabled() || !g_Game)
+			return;
+
+		Scan();
+		if (s_Files.Count() == 0 && s_Buffer.Count() == 0)
+			return;
+
+		s_Replaying = true;
+		ScheduleReplay();
+	}
+
+	/**
+	    \brief Handle end of a replay request.
+	    \param success Backend accepted the record
+	*/
+	static void OnReplayDone(bool success)
+	{
+		if (!s_Replaying)
+			return;
+
+		if (!success) {
+			// the failed record is replayed first next time
+			s_Replaying = false;
+			s_ReplayPos = s_ReplayStart;
+			s_ReplayLast = false;
+			TrimReplayFile();
+			return;
+		}
+
+		s_TotalReplayed++;
+		if (s_ReplayLast)
+			DropReplayFile();
+
+		ScheduleReplay();
+	}
+
+	/**
+	    \brief Emit metrics to sink.
+	*/
+	static void Flush(MetricZ_SinkBase sink)
+	{
+		if (!sink || !IsEnabled())
+			return;
+
+		s_MetricSpooled.Set(s_TotalSpooled);
+		s_MetricSpooled.FlushWithHead(sink);
+
+		s_MetricReplayed.Set(s_TotalReplayed);
+		s_MetricReplayed.FlushWithHead(sink);
+
+		s_MetricDropped.Set(s_TotalDropped);
+		s_MetricDropped.FlushWithHead(sink);
+
+		int segments = 0;
+		if (s_Files)
+			segments = s_Files.Count();
+
+		s_MetricSegments.Set(segments);
+		s_MetricSegments.FlushWithHead(sink);
+	}
+
+	/**
+	    \brief Queue next replay step after the configured interval.
+	*/
+	protected static void ScheduleReplay()
+	{
+		g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(
+		    ReplayStep,
+		    MetricZ_Config.Get().http.spool_replay_interval_ms,
+		    false);
+	}
+
+	/**
+	    \brief Post the next spooled record.
+	*/
+	protected static void ReplayStep()
+	{
+		MetricZ_RestClient client = MetricZ_RestClient.Get();
+		if (!client || !MetricZ_RestBreaker.IsClosed()) {
+			s_Replaying = false;
+			TrimReplayFile();
+			return;
+		}
+
+		if (s_ReplayFile == string.Empty && !LoadSegment()) {
+			s_Replaying = false;
+			return;
+		}
+
+		int start = s_ReplayPos;
+		int size = s_ReplayData.Length();
+		int nl = s_ReplayData.IndexOfFrom(start, "\n");
+		if (nl < 0)
+			nl = size;
+
+		array<string> header = new array<string>();
+		string body;
+		int end = size;
+
+		string line = s_ReplayData.Substring(start, nl - start);
+		if (line.IndexOf(HEADER) == 0)
+			line.Split(" ", header);
+
+		if (header.Count() >= 5) {
+			int length = header[4].ToInt();
+			if (length >= 0 && nl + 1 + length <= size) {
+				body = s_ReplayData.Substring(nl + 1, length);
+				end = Math.Min(nl + 2 + length, size);
+			} else {
+				ErrorEx("MetricZ: spool record length out of segment " + s_ReplayFile, ErrorExSeverity.WARNING);
+			}
+		} else if (header.Count() >= 3) {
+			// record without length ends at the next header
+			int next = s_ReplayData.IndexOfFrom(nl, "\n" + HEADER);
+			if (next >= 0)
+				end = next + 1;
+
+			if (end > nl + 1) {
+				body = s_ReplayData.Substring(nl + 1, end - nl - 1);
+				body.TrimInPlace();
+			}
+		}
+
+		s_ReplayStart = start;
+		s_ReplayPos = end;
+		s_ReplayLast = (end >= size);
+
+		// malformed record, skip it
+		if (body == string.Empty) {
+			if (s_ReplayLast)
+				DropReplayFile();
+
+			ScheduleReplay();
+			return;
+		}
+
+		bool partial = (header.Count() >= 5 && header[3] == "part");
+		client.PostReplay(body, header[1], header[2] == "json", partial, new MetricZ_CallbackReplay(client));
+	}
+
+	/**
+	    \brief Cut replayed records from the loaded segment file.
+	    \details Called when the replay stops in the middle of a segment.
+	*/
+	protected static void TrimReplayFile()
+	{
+		if (s_ReplayFile == string.Empty || s_ReplayPos <= 0)
+			return;
+
+		s_ReplayData = s_ReplayData.Substring(s_ReplayPos, s_ReplayData.Length() - s_ReplayPos);
+		s_ReplayPos = 0;
+		s_ReplayStart = 0;
+
+		if (s_ReplayData == string.Empty) {
+			DropReplayFile();
+			return;
+		}
+
+		FileHandle fh = OpenFile(s_ReplayFile, FileMode.WRITE);
+		if (fh == 0) {
+			ErrorEx("MetricZ: fail open spool file: " + s_ReplayFile, ErrorExSeverity.ERROR);
+			return;
+		}
+
+		FPrint(fh, s_ReplayData);
+		CloseFile(fh);
+	}
+
+	/**
+	    \brief Load the oldest segment into memory, writing buffered records first.
+	    \return \p bool True if a segment with data was loaded
+	*/
+	protected static bool LoadSegment()
+	{
+		Scan();
+
+		if (s_Files.Count() == 0)
+			WriteSegment();
+
+		while (s_Files.Count() > 0) {
+			s_ReplayFile = s_Files[0];
+			s_ReplayData = string.Empty;
+			s_ReplayPos = 0;
+			s_ReplayStart = 0;
+
+			// segment grows past its size by the last record, read until the end of file
+			FileHandle fh = OpenFile(s_ReplayFile, FileMode.READ);
+			if (fh != 0) {
+				string part;
+				int read = ReadFile(fh, part, MetricZ_Constants.SPOOL_SEGMENT_SIZE);
+				while (read > 0) {
+					s_ReplayData += part;
+					part = string.Empty;
+					read = ReadFile(fh, part, MetricZ_Constants.SPOOL_SEGMENT_SIZE);
+				}
+
+				CloseFile(fh);
+			}
+
+			if (s_ReplayData != string.Empty)
+				return true;
+
+			DropReplayFile();
+		}
+
+		return false;
+	}
+
+	/**
+	    \brief Delete the replayed segment file.
+	*/
+	protected static void DropReplayFile()
+	{
+		int idx = s_Files.Find(s_ReplayFile);
+		if (idx >= 0)
+			s_Files.RemoveOrdered(idx);
+
+		DeleteFile(s_ReplayFile);
+		CloseReplay();
+	}
+
+	/**
+	    \brief Forget the loaded segment.
+	*/
+	protected static void CloseReplay()
+	{
+		s_ReplayFile = string.Empty;
+		s_ReplayData = string.Empty;
+		s_ReplayPos = 0;
+		s_ReplayStart = 0;
+		s_ReplayLast = false;
+	}
+
+	/**
+	    \brief List segment files left by previous sessions, once.
+	*/
+	protected static void Scan()
+	{
+		if (s_Files)
+			return;
+
+		s_Files = new array<string>();
+
+		string name;
+		FileAttr attr;
+		FindFileHandle handle = FindFile(MetricZ_Constants.SPOOL_DIR + "*.spool", name, attr, FindFileFlags.ALL);
+		if (!handle)
+			return;
+
+		bool found = true;
+		while (found) {
+			if (name != string.Empty)
+				s_Files.Insert(MetricZ_Constants.SPOOL_DIR + name);
+
+			found = FindNextFile(handle, name, attr);
+		}
+
+		CloseFindFile(handle);
+		s_Files.Sort();
+
+		if (s_Files.Count() > 0)
+			ErrorEx("MetricZ: found " + s_Files.Count() + " spool segments to replay", ErrorExSeverity.INFO);
+	}
+}
+#endif
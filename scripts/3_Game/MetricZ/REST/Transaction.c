@@ -0,0 +1,42 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief State of one REST transaction in the window of `MetricZ_RestTransactionManager`.
+*/
+class MetricZ_RestTransaction
+{
+	string m_Id; //!< Transaction ID
+	int m_Seq; //!< Sequence number
+	float m_StartedAt; //!< Tick time (seconds) of Start()
+	bool m_Sealed; //!< Sink has finished generating all chunks
+	bool m_Committing; //!< Commit request was posted
+	ref array<bool> m_Chunks = new array<bool>(); //!< Status of each chunk (true = uploaded)
+
+	// Delta uploads
+	bool m_Keyframe; //!< Transaction carries all series
+	int m_BaseSeq = -1; //!< Sequence of the committed transaction the delta is based on, -1 if none
+	ref map<string, string> m_Base; //!< Series -> value of the base transaction
+	ref map<string, string> m_Current = new map<string, string>(); //!< Series -> value written by this transaction
+
+	/**
+	    \brief Check if all chunks are uploaded and nothing more will come.
+	*/
+	bool IsComplete()
+	{
+		if (!m_Sealed || m_Chunks.Count() == 0)
+			return false;
+
+		foreach (bool done : m_Chunks) {
+			if (!done)
+				return false;
+		}
+
+		return true;
+	}
+}
+#endif
@@ -7,33 +7,83 @@
 #ifdef SERVER
 /**
     \brief Static manager for REST transaction state.
-    \details Acts as the "Source of Truth" for the current metric collection cycle.
+    \details Acts as the "Source of Truth" for the metric collection cycles being uploaded.
              Decouples upload state from the transient `RestSink` object and handles
              synchronization between asynchronous chunk uploads and the final commit.
+             Up to `http.max_transactions` transactions are kept in a window, each with own chunk
+             status and seal flag, so a slow upload is not abandoned when the next cycle starts.
+             Commits are posted in transaction order. When the window is full, the oldest
+             transaction is dropped.
+             With `http.delta` it also keeps the last acknowledged value of every series,
+             so only changed series, removed series and periodic full keyframes are uploaded.
 */
 class MetricZ_RestTransactionManager
 {
-	protected static string s_CurrentTxn; //!< The currently active transaction ID
-	protected static bool s_Sealed; //!< True if Sink has finished generating all chunks
-	protected static ref array<bool> s_Chunks; //!< Status of each chunk (true = uploaded)
+	protected static ref array<ref MetricZ_RestTransaction> s_Window = new array<ref MetricZ_RestTransaction>(); //!< Active transactions, oldest first
+
+	// Delta uploads
+	protected static int s_Seq; //!< Sequence number of the last started transaction
+	protected static bool s_ForceKeyframe; //!< Next transaction must be a keyframe
+	protected static int s_SinceKeyframe; //!< Transactions started since the last keyframe
+	protected static int s_AckedSeq = -1; //!< Sequence of the last committed transaction, -1 if none
+	protected static ref map<string, string> s_Acked = new map<string, string>(); //!< Series -> value known by the backend
 
 	/**
 	    \brief Start a new transaction.
-	    \details Resets state. Any old callbacks will be ignored after this.
+	    \details Appends it to the window. If the window is full, the oldest transaction
+	             without a commit in flight is dropped (the oldest one if all are committing),
+	             complete transactions queued behind it are committed.
 	    \param txn Transaction ID to start
 	*/
 	static void Start(string txn)
 	{
-		s_CurrentTxn = txn;
-		s_Sealed = false;
+		int limit = MetricZ_Config.Get().http.max_transactions;
+		bool evicted = false;
+		while (s_Window.Count() >= limit) {
+			int drop = 0;
+			int count = s_Window.Count();
+			for (int i = 0; i < count; i++) {
+				if (!s_Window[i].m_Committing) {
+					drop = i;
+					break;
+				}
+			}
+
+			ErrorEx("MetricZ: transaction window is full, drop " + s_Window[drop].m_Id, ErrorExSeverity.WARNING);
+			s_Window.RemoveOrdered(drop);
+			evicted = true;
+
+			// chunks of the evicted transaction may carry table entries the backend never stores
+			MetricZ_RestDictionary.OnLost(MetricZ_RestDictionary.GetSession());
+		}
+
+		if (evicted)
+			CheckCommit();
+
+		MetricZ_RestTransaction t = new MetricZ_RestTransaction();
+		t.m_Id = txn;
+		t.m_StartedAt = g_Game.GetTickTime();
 
-		if (!s_Chunks)
-			s_Chunks = new array<bool>();
-		else
-			s_Chunks.Clear();
+		s_Seq++;
+		t.m_Seq = s_Seq;
+
+		int every = MetricZ_Config.Get().http.delta_keyframe_every;
+		t.m_Keyframe = (s_ForceKeyframe || s_AckedSeq < 0 || s_SinceKeyframe >= every);
+		if (t.m_Keyframe) {
+			s_ForceKeyframe = false;
+			s_SinceKeyframe = 0;
+		}
+
+		s_SinceKeyframe++;
+
+		// s_Acked is replaced, never modified, so the reference is a stable snapshot
+		t.m_Base = s_Acked;
+		t.m_BaseSeq = s_AckedSeq;
+
+		s_Window.Insert(t);
 
 #ifdef DIAG
-		ErrorEx("MetricZ: Txn started: " + txn, ErrorExSeverity.INFO);
+		ErrorEx("MetricZ: Txn started: " + txn + ", window " + s_Window.Count(), ErrorExSeverity.INFO);
 #endif
 	}
 
@@ -44,11 +94,12 @@ class MetricZ_RestTransactionManager
 	*/
 	static int AddChunk(string txn)
 	{
-		if (txn != s_CurrentTxn)
+		MetricZ_RestTransaction t = FindOpen(txn);
+		if (!t)
 			return -1;
 
-		s_Chunks.Insert(false);
-		return s_Chunks.Count() - 1;
+		t.m_Chunks.Insert(false);
+		return t.m_Chunks.Count() - 1;
 	}
 
 	/**
@@ -57,10 +108,17 @@ class MetricZ_RestTransactionManager
 	*/
 	static void Seal(string txn)
 	{
-		if (txn != s_CurrentTxn)
+		MetricZ_RestTransaction t = FindOpen(txn);
+		if (!t)
 			return;
 
-		s_Sealed = true;
+		// nothing was uploaded, nothing to commit
+		if (t.m_Chunks.Count() == 0) {
+			Abort(txn);
+			return;
+		}
+
+		t.m_Sealed = true;
 		CheckCommit();
 	}
 
@@ -71,50 +129,229 @@ class MetricZ_RestTransactionManager
 	*/
 	static void OnChunkSuccess(string txn, int idx)
 	{
-		if (txn != s_CurrentTxn) {
+		MetricZ_RestTransaction t = FindOpen(txn);
+		if (!t) {
 #ifdef DIAG
-			ErrorEx("MetricZ: transaction ignored zombie chunk: " + txn + " (current: " + s_CurrentTxn + ")", ErrorExSeverity.INFO);
+			ErrorEx("MetricZ: transaction ignored zombie chunk: " + txn, ErrorExSeverity.INFO);
 #endif
 			return;
 		}
 
-		if (idx >= 0 && idx < s_Chunks.Count()) {
-			s_Chunks.Set(idx, true);
+		if (idx >= 0 && idx < t.m_Chunks.Count()) {
+			t.m_Chunks.Set(idx, true);
 			CheckCommit();
 		}
 	}
 
 	/**
-	    \brief Check if txn is active (for retries)
+	    \brief Drop a transaction whose chunks will never be uploaded.
+	    \param txn Transaction ID
+	*/
+	static void Abort(string txn)
+	{
+		int idx = IndexOf(txn);
+		if (idx < 0)
+			return;
+
+		s_Window.RemoveOrdered(idx);
+		MetricZ_RestDictionary.OnLost(MetricZ_RestDictionary.GetSession());
+		CheckCommit();
+	}
+
+	/**
+	    \brief Drop all transactions and the delta base, e.g. after the client switched endpoints.
+	    \details The new endpoint has no chunks of open transactions, no series table and no
+	             committed state, so the next transaction is a keyframe in a new dictionary session.
+	*/
+	static void Reset()
+	{
+		if (s_Window.Count() > 0)
+			ErrorEx("MetricZ: drop " + s_Window.Count() + " open transaction(s) of previous endpoint", ErrorExSeverity.WARNING);
+
+		s_Window.Clear();
+		s_Acked = new map<string, string>();
+		s_AckedSeq = -1;
+		s_ForceKeyframe = true;
+
+		MetricZ_RestDictionary.OnLost(MetricZ_RestDictionary.GetSession());
+	}
+
+	/**
+	    \brief Record series value of the current transaction in delta mode.
+	    \param txn Transaction ID
+	    \param series Series text from MetricZ_RestDictionary::SplitLine()
+	    \param value Sample value, empty for HELP/TYPE lines
+	    \return bool True if the line must be uploaded (keyframe, new or changed series)
+	*/
+	static bool Track(string txn, string series, string value)
+	{
+		MetricZ_RestTransaction t = FindOpen(txn);
+		if (!t)
+			return true;
+
+		t.m_Current.Set(series, value);
+
+		if (t.m_Keyframe)
+			return true;
+
+		string acked;
+		if (!t.m_Base.Find(series, acked))
+			return true;
+
+		return (acked != value);
+	}
+
+	/**
+	    \brief Collect series known by the backend that were not written in the current transaction.
+	    \param txn Transaction ID
+	    \param[out] stale Receives removed series, nothing for keyframes
+	*/
+	static void GetStale(string txn, array<string> stale)
+	{
+		MetricZ_RestTransaction t = FindOpen(txn);
+		if (!t || t.m_Keyframe)
+			return;
+
+		foreach (string series, string value : t.m_Base) {
+			if (!t.m_Current.Contains(series))
+				stale.Insert(series);
+		}
+	}
+
+	/**
+	    \brief Handle commit response.
+	    \details The committed snapshot becomes the base of the next deltas,
+	             `resync` response forces a keyframe.
+	    \param txn Committed transaction ID
+	    \param data Response body
+	*/
+	static void OnCommitSuccess(string txn, string data)
+	{
+		int idx = IndexOf(txn);
+		if (idx < 0)
+			return;
+
+		MetricZ_RestTransaction t = s_Window[idx];
+		s_Window.RemoveOrdered(idx);
+
+		MetricZ_HttpStats.ObserveTransaction(g_Game.GetTickTime() - t.m_StartedAt);
+
+		if (!MetricZ_Config.Get().http.delta)
+			return;
+
+		if (data.Contains(MetricZ_RestDictionary.RESYNC)) {
+			s_ForceKeyframe = true;
+			ErrorEx("MetricZ: backend requested delta keyframe", ErrorExSeverity.WARNING);
+		} else if (t.m_Seq > s_AckedSeq) {
+			s_Acked = t.m_Current;
+			s_AckedSeq = t.m_Seq;
+		}
+	}
+
+	/**
+	    \brief Forget a transaction after its commit request finished or gave up.
+	    \param txn Committed transaction ID
+	*/
+	static void OnCommitDone(string txn)
+	{
+		int idx = IndexOf(txn);
+		if (idx >= 0)
+			s_Window.RemoveOrdered(idx);
+	}
+
+	/**
+	    \brief Check if txn is in the window, open or committing (for commit retries)
+	    \param txn Transaction ID to check
+	*/
+	static bool IsPending(string txn)
+	{
+		return (IndexOf(txn) >= 0);
+	}
+
+	/**
+	    \brief Count transactions in the window.
+	*/
+	static int Count()
+	{
+		return s_Window.Count();
+	}
+
+	/**
+	    \brief Check if txn is in the window and accepts chunks (for retries)
 	    \param txn Transaction ID to check
 	    \return bool true if the transaction is active.
 	*/
 	static bool IsActive(string txn)
 	{
-		return (txn != string.Empty && txn == s_CurrentTxn);
+		return (FindOpen(txn) != null);
+	}
+
+	/**
+	    \brief Find transaction which is not committing yet.
+	    \param txn Transaction ID
+	    \return \p MetricZ_RestTransaction or null
+	*/
+	protected static MetricZ_RestTransaction FindOpen(string txn)
+	{
+		int idx = IndexOf(txn);
+		if (idx < 0 || s_Window[idx].m_Committing)
+			return null;
+
+		return s_Window[idx];
+	}
+
+	/**
+	    \brief Get position of a transaction in the window.
+	    \param txn Transaction ID
+	    \return \p int Index or -1
+	*/
+	protected static int IndexOf(string txn)
+	{
+		if (txn == string.Empty)
+			return -1;
+
+		int count = s_Window.Count();
+		for (int i = 0; i < count; i++) {
+			if (s_Window[i].m_Id == txn)
+				return i;
+		}
+
+		return -1;
 	}
 
 	/**
 	    \brief Internal check to trigger Commit
-	    \details Triggers the commit if all chunks have been successfully uploaded.
+	    \details Commits complete transactions from the oldest one, stops at the first incomplete,
+	             so commits are posted in transaction order.
 	*/
 	protected static void CheckCommit()
 	{
-		if (!s_Sealed || s_Chunks.Count() == 0)
+		MetricZ_RestClient client = MetricZ_RestClient.Get();
+		if (!client)
 			return;
 
-		foreach (bool done : s_Chunks) {
-			if (!done)
+		bool delta = MetricZ_Config.Get().http.delta;
+		string query;
+
+		foreach (MetricZ_RestTransaction t : s_Window) {
+			if (t.m_Committing)
+				continue;
+
+			if (!t.IsComplete())
 				return;
-		}
 
-		// Trigger commit
-		MetricZ_RestClient client = MetricZ_RestClient.Get();
-		if (client) {
-			MetricZ_CallbackCommitMetrics cb = new MetricZ_CallbackCommitMetrics(client);
-			client.CommitMetrics(s_CurrentTxn, cb);
+			query = string.Empty;
+			if (delta) {
+				if (t.m_Keyframe)
+					query = string.Format("?mode=keyframe&seq=%1", t.m_Seq);
+				else
+					query = string.Format("?mode=delta&seq=%1&base=%2", t.m_Seq, t.m_BaseSeq);
+			}
+
+			t.m_Committing = true;
 
-			s_CurrentTxn = string.Empty;
+			MetricZ_CallbackCommitMetrics cb = new MetricZ_CallbackCommitMetrics(client);
+			client.CommitMetrics(t.m_Id, cb, query);
 		}
 	}
 }
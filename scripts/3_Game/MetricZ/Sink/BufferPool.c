@@ -0,0 +1,183 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Pool of sink buffers: line arrays for JSON encoding and text builders for Prometheus text.
+    \details Sinks take a buffer in Begin() and return it in End(), so the same arrays and builders
+             are used every cycle. Buffers are reserved at the high-water mark of the previous cycle
+             (`MetricZ_Constants.SINK_BUFFER_PREALLOC` lines before the first one),
+             at most `MetricZ_Constants.SINK_BUFFER_POOL_SIZE` free buffers of each kind are kept.
+*/
+class MetricZ_BufferPool
+{
+	protected static ref array<ref array<string>> s_Free = new array<ref array<string>>(); //!< Free buffers
+	protected static ref array<ref MetricZ_TextBuilder> s_FreeText = new array<ref MetricZ_TextBuilder>(); //!< Free text builders
+	protected static int s_Peak; //!< Most lines held by one buffer since the last Release()
+	protected static int s_HighWater; //!< Peak of the previous cycle, reservation of buffers
+
+	// Stats
+	protected static int s_TotalAcquired; //!< Total buffers handed out
+	protected static int s_TotalReused; //!< Total buffers handed out from the pool
+
+	// Metrics
+	protected static ref MetricZ_MetricInt s_MetricAcquired = new MetricZ_MetricInt(
+	    "sink_buffer_pool_acquired",
+	    "Total line buffers and text builders taken by sinks",
+	    MetricZ_MetricType.COUNTER);
+	protected static ref MetricZ_MetricInt s_MetricReused = new MetricZ_MetricInt(
+	    "sink_buffer_pool_reused",
+	    "Total line buffers and text builders taken by sinks from the pool instead of allocating",
+	    MetricZ_MetricType.COUNTER);
+	protected static ref MetricZ_MetricInt s_MetricFree = new MetricZ_MetricInt(
+	    "sink_buffer_pool_free",
+	    "Free line buffers and text builders in the pool",
+	    MetricZ_MetricType.GAUGE);
+	protected static ref MetricZ_MetricInt s_MetricCapacity = new MetricZ_MetricInt(
+	    "sink_buffer_pool_capacity_lines",
+	    "Lines reserved for line buffers, high-water mark of the previous cycle",
+	    MetricZ_MetricType.GAUGE);
+
+	/**
+	    \brief Take a buffer from the pool or allocate a new one.
+	    \return \p array<string> Empty buffer
+	*/
+	static array<string> Acquire()
+	{
+		s_TotalAcquired++;
+
+		array<string> lines;
+		int last = s_Free.Count() - 1;
+		if (last >= 0) {
+			lines = s_Free[last];
+			s_Free.Remove(last);
+			s_TotalReused++;
+		} else {
+			lines = new array<string>();
+		}
+
+		lines.Reserve(Reservation());
+
+		return lines;
+	}
+
+	/**
+	    \brief Take a text builder from the pool or allocate a new one.
+	    \return \p MetricZ_TextBuilder Empty builder
+	*/
+	static MetricZ_TextBuilder AcquireText()
+	{
+		s_TotalAcquired++;
+
+		MetricZ_TextBuilder text;
+		int last = s_FreeText.Count() - 1;
+		if (last >= 0) {
+			text = s_FreeText[last];
+			s_FreeText.Remove(last);
+			s_TotalReused++;
+		} else {
+			text = new MetricZ_TextBuilder();
+		}
+
+		text.Reserve(Reservation());
+
+		return text;
+	}
+
+	/**
+	    \brief Record the size of a buffer before it is cleared.
+	    \param count Lines in the buffer
+	*/
+	static void Observe(int count)
+	{
+		if (count > s_Peak)
+			s_Peak = count;
+	}
+
+	/**
+	    \brief Return a buffer to the pool.
+	    \details The peak seen since the previous release becomes the reservation of new buffers.
+	    \param lines Buffer taken by Acquire()
+	*/
+	static void Release(array<string> lines)
+	{
+		if (!lines)
+			return;
+
+		Observe(lines.Count());
+		Settle();
+
+		if (s_Free.Count() >= MetricZ_Constants.SINK_BUFFER_POOL_SIZE)
+			return;
+
+		lines.Clear();
+		s_Free.Insert(lines);
+	}
+
+	/**
+	    \brief Return a text builder to the pool.
+	    \param text Builder taken by AcquireText()
+	*/
+	static void ReleaseText(MetricZ_TextBuilder text)
+	{
+		if (!text)
+			return;
+
+		Observe(text.Count());
+		Settle();
+
+		if (s_FreeText.Count() >= MetricZ_Constants.SINK_BUFFER_POOL_SIZE)
+			return;
+
+		text.Clear();
+		s_FreeText.Insert(text);
+	}
+
+	/**
+	    \brief Emit metrics to sink.
+	    \param sink MetricZ_SinkBase sink instance
+	*/
+	static void Flush(MetricZ_SinkBase sink)
+	{
+		if (!sink || s_TotalAcquired == 0)
+			return;
+
+		s_MetricAcquired.Set(s_TotalAcquired);
+		s_MetricAcquired.FlushWithHead(sink);
+
+		s_MetricReused.Set(s_TotalReused);
+		s_MetricReused.FlushWithHead(sink);
+
+		s_MetricFree.Set(s_Free.Count() + s_FreeText.Count());
+		s_MetricFree.FlushWithHead(sink);
+
+		s_MetricCapacity.Set(s_HighWater);
+		s_MetricCapacity.FlushWithHead(sink);
+	}
+
+	/**
+	    \brief Lines to reserve in a new buffer.
+	*/
+	protected static int Reservation()
+	{
+		if (s_HighWater > 0)
+			return s_HighWater;
+
+		return MetricZ_Constants.SINK_BUFFER_PREALLOC;
+	}
+
+	/**
+	    \brief The peak seen since the previous release becomes the reservation of new buffers.
+	*/
+	protected static void Settle()
+	{
+		if (s_Peak > 0)
+			s_HighWater = s_Peak;
+
+		s_Peak = 0;
+	}
+}
+#endif
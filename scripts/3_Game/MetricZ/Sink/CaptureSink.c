@@ -0,0 +1,80 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Sink that remembers lines of one collector.
+    \details Forwards every line to the target sink and keeps a copy,
+             so the block can be written again by Replay() on cycles where the collector is not due.
+*/
+class MetricZ_CaptureSink : MetricZ_SinkBase
+{
+	private MetricZ_SinkBase m_Target; //!< Active sink of the current cycle
+	private ref array<string> m_Lines = new array<string>(); //!< Lines of the last complete capture
+	private float m_CaptureTime = -1; //!< Tick time (seconds) of the last complete capture, -1 if none
+
+	/**
+	    \brief Start recording a new block.
+	    \param target Sink receiving the lines
+	*/
+	void Start(MetricZ_SinkBase target)
+	{
+		m_Target = target;
+		m_Lines.Clear();
+		m_CaptureTime = -1;
+	}
+
+	/**
+	    \brief Finish recording, the block becomes available for Replay().
+	*/
+	void Stop()
+	{
+		m_Target = null;
+		m_CaptureTime = g_Game.GetTickTime();
+	}
+
+	/**
+	    \brief Check if the recorded block is younger than the interval.
+	    \details Half of `settings.collect_interval_sec` is tolerated, so scheduling jitter
+	             does not push a collector to the next cycle.
+	    \param intervalSec Collector interval in seconds
+	    \return \p bool True if the block can be replayed instead of collecting
+	*/
+	bool IsFresh(int intervalSec)
+	{
+		if (m_CaptureTime < 0 || intervalSec <= 0)
+			return false;
+
+		float age = g_Game.GetTickTime() - m_CaptureTime;
+		float slack = MetricZ_Config.Get().settings.collect_interval_sec * 0.5;
+
+		return (age + slack < intervalSec);
+	}
+
+	/**
+	    \brief Write the recorded block into sink.
+	    \param sink MetricZ_SinkBase sink instance
+	*/
+	void Replay(MetricZ_SinkBase sink)
+	{
+		foreach (string line : m_Lines)
+			sink.Line(line);
+	}
+
+	/**
+	    \brief Record and forward a metric line.
+	    \param line Metric line to write
+	*/
+	override void Line(string line)
+	{
+		if (!m_Target)
+			return;
+
+		m_Lines.Insert(line);
+		m_Target.Line(line);
+	}
+}
+#endif
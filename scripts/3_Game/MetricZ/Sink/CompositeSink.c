@@ -8,28 +8,57 @@
 /**
     \brief Composite Sink pattern.
     \details Forwards metric lines to multiple registered sinks (e.g., File and REST simultaneously).
-             Note: Not recommended for production due to double overhead.
+             Sinks accepting chunks (see MetricZ_SinkBase.GetChunkEncoding()) share one line buffer
+             of the composite, every chunk is joined as text and serialized as JSON at most once
+             and the same payload is handed to each of them, only sinks with the same buffer limit
+             share the buffer. Other sinks get single lines, sinks taking samples get the
+             sample values and a line is rendered once for the rest.
 */
 class MetricZ_CompositeSink : MetricZ_SinkBase
 {
 	private ref array<ref MetricZ_SinkBase> m_Sinks; //!< List of sinks to forward metrics to
+	private ref array<MetricZ_SinkBase> m_ChunkSinks; //!< Sinks fed from the shared buffer
+	private ref array<MetricZ_SinkBase> m_LineSinks; //!< Sinks fed line by line
+	private ref array<MetricZ_SinkBase> m_SampleSinks; //!< Line sinks taking sample values, see MetricZ_SinkBase.TakesSamples()
+	private int m_SharedLimit; //!< Buffer limit of the shared buffer, 0 until a chunk sink is added
 
 	void MetricZ_CompositeSink()
 	{
 		m_Sinks = new array<ref MetricZ_SinkBase>();
+		m_ChunkSinks = new array<MetricZ_SinkBase>();
+		m_LineSinks = new array<MetricZ_SinkBase>();
+		m_SampleSinks = new array<MetricZ_SinkBase>();
 	}
 
 	/**
 	    \brief Adds a sink to the composite list.
+	    \details The first chunk sink sets the limit of the shared buffer,
+	             a sink with a different limit gets single lines and keeps its own chunking.
 	    \param sink Sink to add
 	    \param bufferLimit Buffer limit for the sink
 	*/
 	void AddSink(MetricZ_SinkBase sink, int bufferLimit)
 	{
-		if (sink) {
-			sink.SetBuffer(bufferLimit);
-			m_Sinks.Insert(sink);
+		if (!sink)
+			return;
+
+		sink.SetBuffer(bufferLimit);
+		m_Sinks.Insert(sink);
+
+		bool differs = (m_SharedLimit != 0 && bufferLimit != m_SharedLimit);
+		if (sink.GetChunkEncoding() == MetricZ_ChunkEncoding.NONE || bufferLimit == 0 || differs) {
+			m_LineSinks.Insert(sink);
+			if (sink.TakesSamples())
+				m_SampleSinks.Insert(sink);
+
+			return;
 		}
+
+		m_ChunkSinks.Insert(sink);
+		sink.SetChunkFed();
+
+		m_SharedLimit = bufferLimit;
+		SetBuffer(m_SharedLimit);
 	}
 
 	/**
@@ -63,10 +92,102 @@ class MetricZ_CompositeSink : MetricZ_SinkBase
 		if (!IsBusy())
 			return;
 
-		foreach (MetricZ_SinkBase sink : m_Sinks)
+		super.Line(line);
+
+		foreach (MetricZ_SinkBase sink : m_LineSinks)
 			sink.Line(line);
 	}
 
+	/**
+	    \brief Take samples if any of the sinks does.
+	*/
+	override bool TakesSamples()
+	{
+		return (m_SampleSinks.Count() > 0);
+	}
+
+	/**
+	    \brief Hand an integer sample to sinks taking samples, other sinks get the rendered line.
+	    \param desc Family descriptor
+	    \param labels Label block with braces
+	    \param value Sample value
+	*/
+	override void SampleInt(MetricZ_MetricDescriptor desc, string labels, int value)
+	{
+		if (!IsBusy())
+			return;
+
+		string line = string.Format("%1%2 %3", desc.GetName(), labels, value);
+		super.Line(line);
+
+		foreach (MetricZ_SinkBase sink : m_LineSinks) {
+			if (sink.TakesSamples())
+				sink.SampleInt(desc, labels, value);
+			else
+				sink.Line(line);
+		}
+	}
+
+	/**
+	    \brief Hand a float sample to sinks taking samples, other sinks get the rendered line.
+	    \param desc Family descriptor
+	    \param labels Label block with braces
+	    \param value Sample value
+	*/
+	override void SampleFloat(MetricZ_MetricDescriptor desc, string labels, float value)
+	{
+		if (!IsBusy())
+			return;
+
+		string line = string.Format("%1%2 %3", desc.GetName(), labels, value);
+		super.Line(line);
+
+		foreach (MetricZ_SinkBase sink : m_LineSinks) {
+			if (sink.TakesSamples())
+				sink.SampleFloat(desc, labels, value);
+			else
+				sink.Line(line);
+		}
+	}
+
+	/**
+	    \brief Forwards start of collector block to all sinks.
+	    \param name Collector name
+	*/
+	override void BeginBlock(string name)
+	{
+		if (!IsBusy())
+			return;
+
+		foreach (MetricZ_SinkBase sink : m_Sinks)
+			sink.BeginBlock(name);
+	}
+
+	/**
+	    \brief Forwards end of collector block to all sinks.
+	    \details The shared buffer is written when every chunk sink agrees.
+	*/
+	override void EndBlock()
+	{
+		if (!IsBusy())
+			return;
+
+		int lines = GetBufferCount();
+		if (lines > 0) {
+			bool due = true;
+			foreach (MetricZ_SinkBase chunkSink : m_ChunkSinks) {
+				if (!chunkSink.IsBlockFlushDue(lines))
+					due = false;
+			}
+
+			if (due)
+				BufferFlush();
+		}
+
+		foreach (MetricZ_SinkBase sink : m_Sinks)
+			sink.EndBlock();
+	}
+
 	/**
 	    \brief Ends the current batch of metrics.
 	    \details Flushes all sinks and resets the busy state.
@@ -77,6 +198,9 @@ class MetricZ_CompositeSink : MetricZ_SinkBase
 		if (!IsBusy())
 			return false;
 
+		// sinks close their transaction or file in End(), the shared tail goes first
+		BufferFlush();
+
 		bool allEnded = true;
 
 		foreach (MetricZ_SinkBase sink : m_Sinks) {
@@ -88,5 +212,59 @@ class MetricZ_CompositeSink : MetricZ_SinkBase
 
 		return allEnded;
 	}
+
+	/**
+	    \brief Drops the unfinished batch of all sinks.
+	*/
+	override void Abort()
+	{
+		if (!IsBusy())
+			return;
+
+		foreach (MetricZ_SinkBase sink : m_Sinks)
+			sink.Abort();
+
+		super.Abort();
+	}
+
+	/**
+	    \brief Keep shared lines in an array, it is the source of both text and JSON chunks.
+	*/
+	override protected bool IsTextBuffer()
+	{
+		return false;
+	}
+
+	/**
+	    \brief Encode the shared buffer once per required encoding and hand it to chunk sinks.
+	*/
+	override protected void BufferFlush()
+	{
+		if (GetBufferCount() > 0) {
+			string text, json;
+			bool hasText, hasJson;
+
+			foreach (MetricZ_SinkBase sink : m_ChunkSinks) {
+				if (sink.GetChunkEncoding() == MetricZ_ChunkEncoding.JSON) {
+					if (!hasJson) {
+						json = GetJsonBufferChunk();
+						hasJson = true;
+					}
+
+					sink.Chunk(json);
+					continue;
+				}
+
+				if (!hasText) {
+					text = GetBufferChunk();
+					hasText = true;
+				}
+
+				sink.Chunk(text);
+			}
+		}
+
+		super.BufferFlush();
+	}
 }
 #endif
@@ -9,14 +9,71 @@
     \brief Sink implementation for local file export.
     \details Writes metrics to a .prom file (compatible with node-exporter textfile collector).
              Supports atomic writes (write to .tmp -> copy to .prom) to prevent partial reads.
+             Buffered lines are written to the temp file at the end of every collector block,
+             so disk writes are spread over the frames of the flush. The atomic publish runs
+             from the call queue in a later frame, FinishPublish() completes it early when needed.
+             With `file.shard` every collector block is kept in memory and written to its own
+             `<file>_<collector>.prom`, only when the content hash of the block changed.
+             A shard whose block is empty or missing in a cycle is deleted at End(),
+             shards left by previous sessions are deleted by DeleteStaleShards() on init.
+             Names of written shards are kept in the `<prefix>shards.lst` manifest,
+             so only shards of this instance are deleted, never files of other instances.
 */
 class MetricZ_FileSink : MetricZ_SinkBase
 {
 	private FileHandle m_Fh; //!< Native file handle for the active write operation
+	private bool m_Sharded; //!< One file per collector block
+
+	private string m_Block; //!< Name of the open block in shard mode
+	private ref MetricZ_TextBuilder m_BlockText; //!< Lines of the open block
+	private int m_BlockHash; //!< Rolling hash of the open block
+
+	private static ref map<string, int> s_ShardHashes = new map<string, int>(); //!< Shard file -> hash of the last written content
+	private static ref set<string> s_CycleShards = new set<string>(); //!< Shard files with content in the current cycle
+	private static ref array<string> s_ManifestBlocks = new array<string>(); //!< Block names listed in the shard manifest
+	private static bool s_SingleRemoved; //!< Single .prom file was removed after switching to shards
+	private static int s_ShardsWritten; //!< Total shard files written
+	private static int s_ShardsSkipped; //!< Total shard writes skipped as unchanged
+
+	private static bool s_PublishPending; //!< Temp file is closed and waits for the deferred publish
+	private static int s_CycleBytes; //!< Bytes written in the current cycle
+	private static int s_LastBytes; //!< Bytes written in the previous cycle
+	private static float s_LastPublish; //!< Duration of the previous publish, seconds
+
+	private static ref MetricZ_MetricInt s_MetricWrittenBytes = new MetricZ_MetricInt(
+	    "file_written_bytes",
+	    "Bytes written to export files in the previous cycle",
+	    MetricZ_MetricType.GAUGE);
+	private static ref MetricZ_MetricFloat s_MetricPublishDuration = new MetricZ_MetricFloat(
+	    "file_publish_duration_seconds",
+	    "Duration of the previous atomic publish (delete .prom, copy .tmp, delete .tmp), seconds",
+	    MetricZ_MetricType.GAUGE);
+	private static ref MetricZ_MetricInt s_MetricShardsWritten = new MetricZ_MetricInt(
+	    "file_shards_written",
+	    "Total per-collector .prom files rewritten because their content changed",
+	    MetricZ_MetricType.COUNTER);
+	private static ref MetricZ_MetricInt s_MetricShardsSkipped = new MetricZ_MetricInt(
+	    "file_shards_skipped",
+	    "Total per-collector .prom file writes skipped because the content did not change",
+	    MetricZ_MetricType.COUNTER);
+
+	void MetricZ_FileSink()
+	{
+		m_Sharded = MetricZ_Config.IsLoaded() && MetricZ_Config.Get().file.shard && MetricZ_Config.Get().file.shard_file_prefix != string.Empty;
+	}
+
+	/**
+	    \brief Write into the single .prom file even if `file.shard` is enabled (e.g. shutdown status).
+	*/
+	void DisableShards()
+	{
+		m_Sharded = false;
+	}
 
 	/**
 	    \brief Opens the target file for writing.
 	    \details Selects temporary path if atomic mode is enabled, otherwise uses direct path.
+	             In shard mode no file is opened until a block ends.
 	*/
 	override bool Begin()
 	{
@@ -26,6 +83,29 @@ class MetricZ_FileSink : MetricZ_SinkBase
 		if (!super.Begin())
 			return false;
 
+		// previous temp file is not published yet and would be overwritten
+		FinishPublish();
+		s_CycleBytes = 0;
+
+		if (m_Sharded) {
+			// node-exporter would merge stale single file with the shards
+			if (!s_SingleRemoved) {
+				DeleteFile(MetricZ_Config.Get().file.prom_file_path);
+				s_SingleRemoved = true;
+			}
+
+			s_CycleShards.Clear();
+
+			if (!m_BlockText)
+				m_BlockText = new MetricZ_TextBuilder();
+			else
+				m_BlockText.Clear();
+
+			m_Block = string.Empty;
+			BeginBlock("main");
+			return true;
+		}
+
 		string file;
 		if (MetricZ_Config.Get().file.atomic)
 			file = MetricZ_Config.Get().file.temp_file_path;
@@ -35,6 +115,8 @@ class MetricZ_FileSink : MetricZ_SinkBase
 		m_Fh = OpenFile(file, FileMode.WRITE);
 		if (!m_Fh) {
 			ErrorEx("MetricZ: open file '" + file + "' failed", ErrorExSeverity.ERROR);
+			// sink is reused, leave it idle for the next cycle
+			super.End();
 			return false;
 		}
 
@@ -44,51 +126,382 @@ class MetricZ_FileSink : MetricZ_SinkBase
 	/**
 	    \brief Writes a metric line.
 	    \details Delegates to buffer if buffering is enabled, otherwise writes directly to disk.
+	             In shard mode the line is added to the open block.
 	*/
 	override void Line(string line)
 	{
-		if (!IsBusy() || !m_Fh)
+		if (!IsBusy())
+			return;
+
+		if (m_Sharded) {
+			m_BlockText.Append(line);
+			m_BlockHash = m_BlockHash * 31 + line.Hash();
+			MetricZ_FlightRecorder.Line(line);
+			return;
+		}
+
+		if (!m_Fh)
 			return;
 
-		if (IsBuffered())
+		if (IsBuffered()) {
 			super.Line(line);
-		else
-			FPrintln(m_Fh, line);
+			return;
+		}
+
+		FPrintln(m_Fh, line);
+		s_CycleBytes += line.Length() + 1;
+		MetricZ_FlightRecorder.Line(line);
+	}
+
+	/**
+	    \brief Start a new shard, the previous one is written first.
+	    \param name Collector name
+	*/
+	override void BeginBlock(string name)
+	{
+		if (!m_Sharded || !IsBusy())
+			return;
+
+		WriteShard();
+
+		m_Block = name;
+		m_BlockText.Clear();
+		m_BlockHash = 0;
+	}
+
+	/**
+	    \brief Write buffered lines of the finished block to the file.
+	    \details In shard mode the finished shard is written, the next lines go to the `main` shard.
+	*/
+	override void EndBlock()
+	{
+		if (m_Sharded) {
+			BeginBlock("main");
+			return;
+		}
+
+		if (IsBusy() && IsBuffered())
+			BufferFlush();
+	}
+
+	/**
+	    \brief Take text chunks, shard mode needs single lines.
+	*/
+	override MetricZ_ChunkEncoding GetChunkEncoding()
+	{
+		if (m_Sharded)
+			return MetricZ_ChunkEncoding.NONE;
+
+		return MetricZ_ChunkEncoding.TEXT;
+	}
+
+	/**
+	    \brief Write a text chunk rendered by `MetricZ_CompositeSink`.
+	    \param payload Newline terminated lines
+	*/
+	override void Chunk(string payload)
+	{
+		if (!IsBusy() || !m_Fh || payload == string.Empty)
+			return;
+
+		FPrint(m_Fh, payload);
+		s_CycleBytes += payload.Length();
+		MetricZ_FlightRecorder.Write(payload);
 	}
 
 	/**
 	    \brief Closes the file and finalizes the export.
-	    \details If atomic mode is enabled, handles the swap (delete old -> copy tmp to final -> delete tmp).
+	    \details If atomic mode is enabled, the swap (delete old -> copy tmp to final -> delete tmp)
+	             is queued for the next frame.
 	*/
 	override bool End()
 	{
 		if (!MetricZ_Config.IsLoaded())
 			return false;
 
+		if (m_Sharded && IsBusy()) {
+			WriteShard();
+			DeleteEmptyShards();
+		}
+
 		if (!super.End())
 			return false;
 
+		s_LastBytes = s_CycleBytes;
+
+		if (m_Sharded)
+			return true;
+
 		if (m_Fh) {
 			CloseFile(m_Fh);
 			m_Fh = null;
 		}
 
 		if (MetricZ_Config.Get().file.atomic) {
-			string promFile = MetricZ_Config.Get().file.prom_file_path;
-			string tempFile = MetricZ_Config.Get().file.temp_file_path;
+			s_PublishPending = true;
+			g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).Call(FinishPublish);
+		}
 
-			DeleteFile(promFile);
+		return true;
+	}
 
-			if (!CopyFile(tempFile, promFile)) {
-				ErrorEx(
-				    "MetricZ: atomic publish failed '" + tempFile + "' -> '" + promFile + "'",
-				    ErrorExSeverity.ERROR);
-				return false;
-			}
+	/**
+	    \brief Closes the file of the unfinished cycle without publishing it.
+	    \details Shards of the open block are not written, the temp file is left for Shutdown() to delete.
+	*/
+	override void Abort()
+	{
+		if (!IsBusy())
+			return;
 
-			DeleteFile(tempFile);
+		if (m_Sharded) {
+			m_Block = string.Empty;
+			m_BlockText.Clear();
 		}
 
+		if (m_Fh) {
+			CloseFile(m_Fh);
+			m_Fh = null;
+		}
+
+		super.Abort();
+	}
+
+	/**
+	    \brief Publish the closed temp file if the deferred publish did not run yet.
+	    \details Called from the call queue after End(), before the next Begin() and on shutdown.
+	*/
+	static void FinishPublish()
+	{
+		if (!s_PublishPending)
+			return;
+
+		s_PublishPending = false;
+		if (g_Game)
+			g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).Remove(FinishPublish);
+
+		if (!MetricZ_Config.IsLoaded())
+			return;
+
+		float t = g_Game.GetTickTime();
+		Publish(MetricZ_Config.Get().file.temp_file_path, MetricZ_Config.Get().file.prom_file_path);
+		s_LastPublish = g_Game.GetTickTime() - t;
+	}
+
+	/**
+	    \brief Delete all shard files written in this session.
+	*/
+	static void DeleteShards()
+	{
+		foreach (string file, int hash : s_ShardHashes)
+			DeleteFile(file);
+
+		s_ShardHashes.Clear();
+
+		if (s_ManifestBlocks.Count() > 0)
+			DeleteFile(ManifestFile());
+
+		s_ManifestBlocks.Clear();
+	}
+
+	/**
+	    \brief Delete shard files left in the export directory by previous sessions.
+	    \details Called once on init, shard files of this session are rewritten by the first cycle.
+	             Only shards listed in the manifest of this instance are removed,
+	             also when `file.shard` was turned off, node-exporter would merge them.
+	*/
+	static void DeleteStaleShards()
+	{
+		if (!MetricZ_Config.IsLoaded() || MetricZ_Config.Get().file.shard_file_prefix == string.Empty)
+			return;
+
+		string manifest = ManifestFile();
+		FileHandle fh = OpenFile(manifest, FileMode.READ);
+		if (!fh)
+			return;
+
+		string prefix = MetricZ_Config.Get().file.shard_file_prefix;
+		int deleted = 0;
+		string block;
+
+		while (FGets(fh, block) >= 0) {
+			block.TrimInPlace();
+			if (block == string.Empty)
+				continue;
+
+			if (DeleteFile(prefix + block + ".prom"))
+				deleted++;
+
+			DeleteFile(prefix + block + ".tmp");
+		}
+
+		CloseFile(fh);
+		DeleteFile(manifest);
+
+		s_ShardHashes.Clear();
+		s_ManifestBlocks.Clear();
+
+		if (deleted > 0)
+			ErrorEx("MetricZ: deleted " + deleted + " shard files of previous session", ErrorExSeverity.INFO);
+	}
+
+	/**
+	    \brief Account bytes written by another file export sink in the current cycle.
+	    \param bytes Bytes written
+	*/
+	static void AddWrittenBytes(int bytes)
+	{
+		s_CycleBytes += bytes;
+	}
+
+	/**
+	    \brief Account the end of a cycle of another file export sink.
+	*/
+	static void EndCycle()
+	{
+		s_LastBytes = s_CycleBytes;
+		s_CycleBytes = 0;
+	}
+
+	/**
+	    \brief Emit file write statistics of the previous cycle to sink.
+	    \param sink MetricZ_SinkBase sink instance
+	*/
+	static void FlushStats(MetricZ_SinkBase sink)
+	{
+		if (!sink || !MetricZ_Config.IsLoaded() || !MetricZ_Config.Get().file.enabled)
+			return;
+
+		s_MetricWrittenBytes.Set(s_LastBytes);
+		s_MetricWrittenBytes.FlushWithHead(sink);
+
+		if (MetricZ_Config.Get().file.snapshot)
+			return;
+
+		if (MetricZ_Config.Get().file.atomic && !MetricZ_Config.Get().file.shard) {
+			s_MetricPublishDuration.Set(s_LastPublish);
+			s_MetricPublishDuration.FlushWithHead(sink);
+		}
+
+		if (!MetricZ_Config.Get().file.shard)
+			return;
+
+		s_MetricShardsWritten.Set(s_ShardsWritten);
+		s_MetricShardsWritten.FlushWithHead(sink);
+
+		s_MetricShardsSkipped.Set(s_ShardsSkipped);
+		s_MetricShardsSkipped.FlushWithHead(sink);
+	}
+
+	/**
+	    \brief Write the open block to its shard file if the content changed.
+	    \details Unchanged shard is skipped only while its file exists.
+	*/
+	protected void WriteShard()
+	{
+		// empty block leaves its file unmarked, DeleteEmptyShards() removes it
+		if (m_Block == string.Empty || m_BlockText.Count() == 0)
+			return;
+
+		string file = string.Format("%1%2.prom", MetricZ_Config.Get().file.shard_file_prefix, m_Block);
+		s_CycleShards.Insert(file);
+
+		int hash = m_BlockHash + m_BlockText.Count();
+
+		int prev;
+		if (s_ShardHashes.Find(file, prev) && prev == hash && FileExist(file)) {
+			s_ShardsSkipped++;
+			return;
+		}
+
+		if (s_ManifestBlocks.Find(m_Block) < 0)
+			AddToManifest(m_Block);
+
+		bool atomic = MetricZ_Config.Get().file.atomic;
+		string target = file;
+		if (atomic)
+			target = string.Format("%1%2.tmp", MetricZ_Config.Get().file.shard_file_prefix, m_Block);
+
+		FileHandle fh = OpenFile(target, FileMode.WRITE);
+		if (!fh) {
+			ErrorEx("MetricZ: open file '" + target + "' failed", ErrorExSeverity.ERROR);
+			return;
+		}
+
+		string text = m_BlockText.Join();
+		FPrint(fh, text);
+		CloseFile(fh);
+		s_CycleBytes += text.Length();
+
+		if (atomic && !Publish(target, file))
+			return;
+
+		s_ShardHashes.Set(file, hash);
+		s_ShardsWritten++;
+	}
+
+	/**
+	    \brief Get the path of the shard manifest of this instance.
+	*/
+	protected static string ManifestFile()
+	{
+		return MetricZ_Config.Get().file.shard_file_prefix + "shards.lst";
+	}
+
+	/**
+	    \brief List a block in the shard manifest before its first file is written.
+	    \param block Block name
+	*/
+	protected static void AddToManifest(string block)
+	{
+		s_ManifestBlocks.Insert(block);
+
+		FileHandle fh = OpenFile(ManifestFile(), FileMode.APPEND);
+		if (!fh) {
+			ErrorEx("MetricZ: open shard manifest failed", ErrorExSeverity.ERROR);
+			return;
+		}
+
+		FPrintln(fh, block);
+		CloseFile(fh);
+	}
+
+	/**
+	    \brief Delete shard files whose block had no lines in this cycle.
+	*/
+	protected static void DeleteEmptyShards()
+	{
+		array<string> stale = new array<string>();
+		foreach (string file, int hash : s_ShardHashes) {
+			if (s_CycleShards.Find(file) < 0)
+				stale.Insert(file);
+		}
+
+		foreach (string staleFile : stale) {
+			DeleteFile(staleFile);
+			s_ShardHashes.Remove(staleFile);
+		}
+	}
+
+	/**
+	    \brief Replace the .prom file with the temp file.
+	    \param tempFile Written temp file
+	    \param promFile Published file
+	    \return \p bool True on success
+	*/
+	protected static bool Publish(string tempFile, string promFile)
+	{
+		DeleteFile(promFile);
+
+		if (!CopyFile(tempFile, promFile)) {
+			ErrorEx(
+			    "MetricZ: atomic publish failed '" + tempFile + "' -> '" + promFile + "'",
+			    ErrorExSeverity.ERROR);
+			return false;
+		}
+
+		DeleteFile(tempFile);
+
 		return true;
 	}
 
@@ -97,8 +510,12 @@ class MetricZ_FileSink : MetricZ_SinkBase
 	*/
 	override protected void BufferFlush()
 	{
-		if (m_Fh && GetBufferCount() > 0)
-			FPrint(m_Fh, GetBufferChunk());
+		if (m_Fh && GetBufferCount() > 0) {
+			string chunk = GetBufferChunk();
+			FPrint(m_Fh, chunk);
+			s_CycleBytes += chunk.Length();
+			MetricZ_FlightRecorder.Write(chunk);
+		}
 
 		super.BufferFlush();
 	}
@@ -0,0 +1,192 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief On-disk ring of the last `history.cycles` scrape cycles.
+    \details Every cycle is written as Prometheus text into one slot file
+             `MetricZ_Constants.HISTORY_DIR<instance_id>_<slot>.prom`, slots are reused in a ring,
+             a file is truncated and rewritten in place, never deleted.
+             Sinks hand over text they already built (buffer chunks of the file or REST sink),
+             only sinks without a text buffer pass single lines. Slot file format:
+               - `# METRICZ_CYCLE <seq> <epoch>` first line
+               - metric lines of the cycle
+               - `# METRICZ_END` last line, missing if the server stopped in the middle of the cycle
+             A slot is opened on the first recorded text of a cycle, so a cycle that writes nothing
+             does not overwrite the older cycle stored in the slot.
+             After restart the ring continues after the slot with the highest sequence,
+             so the cycles before a crash are kept. `tools/history.sh` extracts a time range.
+*/
+class MetricZ_FlightRecorder
+{
+	static const string HEADER = "# METRICZ_CYCLE "; //!< First line of a slot
+	static const string FOOTER = "# METRICZ_END"; //!< Last line of a complete slot
+
+	protected static FileHandle s_Fh; //!< Slot file of the current cycle
+	protected static int s_Seq = -1; //!< Sequence of the last cycle, -1 until the ring is scanned
+	protected static bool s_Pending; //!< Cycle started, slot is not opened yet
+	protected static int s_Epoch; //!< Start time of the pending cycle, UTC seconds
+
+	/**
+	    \brief Check if history recording is enabled in config.
+	*/
+	static bool IsEnabled()
+	{
+		return MetricZ_Config.IsLoaded() && MetricZ_Config.Get().history.enabled;
+	}
+
+	/**
+	    \brief Check if REST sink has to record, file export records otherwise.
+	*/
+	static bool IsRestSource()
+	{
+		return IsEnabled() && !MetricZ_Config.Get().file.enabled;
+	}
+
+	/**
+	    \brief Start a cycle, its slot is opened on the first recorded text.
+	*/
+	static void BeginCycle()
+	{
+		if (!IsEnabled())
+			return;
+
+		if (s_Fh)
+			EndCycle();
+
+		s_Pending = true;
+		s_Epoch = MetricZ_Time.EpochSecondsUTC();
+	}
+
+	/**
+	    \brief Record text built by a sink.
+	    \param text Newline terminated lines
+	*/
+	static void Write(string text)
+	{
+		if (text != string.Empty && Open())
+			FPrint(s_Fh, text);
+	}
+
+	/**
+	    \brief Record a single line of a sink without text buffer.
+	    \param line Metric line
+	*/
+	static void Line(string line)
+	{
+		if (Open())
+			FPrintln(s_Fh, line);
+	}
+
+	/**
+	    \brief Mark the cycle complete and close the slot.
+	*/
+	static void EndCycle()
+	{
+		s_Pending = false;
+		if (!s_Fh)
+			return;
+
+		FPrintln(s_Fh, FOOTER);
+		CloseFile(s_Fh);
+		s_Fh = null;
+	}
+
+	/**
+	    \brief Close the slot of an unfinished cycle without the footer (shutdown in the middle of a cycle).
+	*/
+	static void AbortCycle()
+	{
+		s_Pending = false;
+		if (!s_Fh)
+			return;
+
+		CloseFile(s_Fh);
+		s_Fh = null;
+	}
+
+	/**
+	    \brief Open the next slot of the ring for a pending cycle.
+	    \return \p bool True if the slot of the current cycle is open
+	*/
+	protected static bool Open()
+	{
+		if (s_Fh)
+			return true;
+
+		if (!s_Pending)
+			return false;
+
+		s_Pending = false;
+
+		if (s_Seq < 0)
+			Scan();
+
+		s_Seq++;
+		s_Fh = OpenFile(SlotFile(s_Seq % MetricZ_Config.Get().history.cycles), FileMode.WRITE);
+		if (!s_Fh) {
+			ErrorEx("MetricZ: open history slot failed", ErrorExSeverity.ERROR);
+			return false;
+		}
+
+		FPrintln(s_Fh, string.Format("%1%2 %3", HEADER, s_Seq, s_Epoch));
+
+		return true;
+	}
+
+	/**
+	    \brief Get the slot file path.
+	    \param slot Slot index
+	*/
+	protected static string SlotFile(int slot)
+	{
+		return string.Format(
+		           "%1%2_%3.prom",
+		           MetricZ_Constants.HISTORY_DIR,
+		           MetricZ_Config.Get().settings.instance_id_resolved,
+		           slot.ToStringLen(3));
+	}
+
+	/**
+	    \brief Find the highest sequence in the ring left by previous sessions, once.
+	*/
+	protected static void Scan()
+	{
+		s_Seq = -1;
+
+		if (!FileExist(MetricZ_Constants.HISTORY_DIR)) {
+			MakeDirectory(MetricZ_Constants.HISTORY_DIR);
+			return;
+		}
+
+		int cycles = MetricZ_Config.Get().history.cycles;
+		for (int slot = 0; slot < cycles; slot++) {
+			FileHandle fh = OpenFile(SlotFile(slot), FileMode.READ);
+			if (!fh)
+				continue;
+
+			string line;
+			FGets(fh, line);
+			CloseFile(fh);
+
+			if (line.IndexOf(HEADER) != 0)
+				continue;
+
+			array<string> parts = new array<string>();
+			line.Split(" ", parts);
+			if (parts.Count() < 3)
+				continue;
+
+			int seq = parts[2].ToInt();
+			if (seq > s_Seq)
+				s_Seq = seq;
+		}
+
+		if (s_Seq >= 0)
+			ErrorEx("MetricZ: history ring continues after cycle " + s_Seq, ErrorExSeverity.INFO);
+	}
+}
+#endif
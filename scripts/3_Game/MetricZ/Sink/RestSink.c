@@ -8,6 +8,8 @@
 /**
     \brief Sink implementation for HTTP REST export.
     \details Buffers metrics and sends them in chunks to `MetricZ_RestClient`.
+             With `http.stream` finished collector blocks are posted from EndBlock(),
+             so serialization is spread over the frames of the flush state machine.
              Delegates transaction state management to `MetricZ_RestTransactionManager`.
 */
 class MetricZ_RestSink : MetricZ_SinkBase
@@ -31,16 +33,28 @@ class MetricZ_RestSink : MetricZ_SinkBase
 			return false;
 
 		m_Client = MetricZ_RestClient.Get();
-		if (!m_Client)
+		if (!m_Client) {
+			// sink is reused, leave it idle for the next cycle
+			super.End();
 			return false;
+		}
+
+		// before the transaction starts, it must not span two endpoints
+		m_Client.CheckFailback();
 
-		if (GetBufferLimit() > 0) {
+		// delta uploads need the commit to learn which values the backend has,
+		// streamed blocks are chunks of one transaction
+		if (GetBufferLimit() > 0 || IsDelta() || IsStream()) {
 			int uuid[4];
 			UUIDApi.Generate(uuid);
 			m_TxnId = UUIDApi.FormatString(uuid);
 			MetricZ_RestTransactionManager.Start(m_TxnId);
 		}
 
+		// after Start(), an evicted transaction resets the session before this one encodes
+		if (IsDictionary())
+			MetricZ_RestDictionary.BeginCycle();
+
 		return true;
 	}
 
@@ -50,10 +64,81 @@ class MetricZ_RestSink : MetricZ_SinkBase
 	*/
 	override void Line(string line)
 	{
-		if (m_Client)
+		if (!m_Client)
+			return;
+
+		bool dictionary = IsDictionary();
+		bool delta = IsDelta();
+
+		// JSON and encoded payloads have no text to share with the recorder
+		if (IsBusy() && (!IsTextBuffer() || dictionary || delta) && MetricZ_FlightRecorder.IsRestSource())
+			MetricZ_FlightRecorder.Line(line);
+
+		if ((!dictionary && !delta) || !IsBusy()) {
+			super.Line(line);
+			return;
+		}
+
+		string series, value;
+		MetricZ_RestDictionary.SplitLine(line, series, value);
+
+		if (delta && !MetricZ_RestTransactionManager.Track(m_TxnId, series, value))
+			return;
+
+		if (dictionary)
+			super.Line(MetricZ_RestDictionary.Encode(series, value));
+		else
 			super.Line(line);
 	}
 
+	/**
+	    \brief Post buffered lines of finished collectors as a chunk.
+	    \details Small blocks are kept in the buffer until `http.stream_min_lines` is reached.
+	*/
+	override void EndBlock()
+	{
+		if (!m_Client || !IsBusy() || !IsStream())
+			return;
+
+		if (GetBufferCount() >= MetricZ_Config.Get().http.stream_min_lines)
+			BufferFlush();
+	}
+
+	/**
+	    \brief Take text or JSON chunks unless lines are encoded by dictionary or delta uploads.
+	*/
+	override MetricZ_ChunkEncoding GetChunkEncoding()
+	{
+		if (IsDictionary() || IsDelta())
+			return MetricZ_ChunkEncoding.NONE;
+
+		if (IsTextBuffer())
+			return MetricZ_ChunkEncoding.TEXT;
+
+		return MetricZ_ChunkEncoding.JSON;
+	}
+
+	/**
+	    \brief Post a chunk rendered by `MetricZ_CompositeSink`.
+	    \param payload Chunk body in the encoding of GetChunkEncoding()
+	*/
+	override void Chunk(string payload)
+	{
+		if (!m_Client || !IsBusy() || payload == string.Empty)
+			return;
+
+		Post(payload);
+	}
+
+	/**
+	    \brief Merge small blocks up to `http.stream_min_lines`, post nothing before End() without `http.stream`.
+	    \param lines Number of buffered lines
+	*/
+	override bool IsBlockFlushDue(int lines)
+	{
+		return IsStream() && lines >= MetricZ_Config.Get().http.stream_min_lines;
+	}
+
 	/**
 	    \brief Ends the transaction.
 	    \details Flushes remaining buffer and tells `TransactionManager` to Seal the transaction.
@@ -63,6 +148,9 @@ class MetricZ_RestSink : MetricZ_SinkBase
 		if (!m_Client)
 			return false;
 
+		if (IsDelta())
+			WriteStale();
+
 		BufferFlush();
 
 		if (m_TxnId != string.Empty)
@@ -73,6 +161,79 @@ class MetricZ_RestSink : MetricZ_SinkBase
 		return super.End();
 	}
 
+	/**
+	    \brief Drops the unfinished transaction, it is never sealed and committed.
+	*/
+	override void Abort()
+	{
+		if (!IsBusy())
+			return;
+
+		if (m_TxnId != string.Empty)
+			MetricZ_RestTransactionManager.Abort(m_TxnId);
+
+		m_TxnId = string.Empty;
+
+		super.Abort();
+	}
+
+	/**
+	    \brief Use line buffer for serialized JSON payloads, text builder otherwise.
+	*/
+	override protected bool IsTextBuffer()
+	{
+		return !MetricZ_Config.IsLoaded() || !MetricZ_Config.Get().http.serialized || IsDictionary();
+	}
+
+	/**
+	    \brief Check if lines are encoded by `MetricZ_RestDictionary`.
+	*/
+	protected bool IsDictionary()
+	{
+		return MetricZ_Config.IsLoaded() && MetricZ_Config.Get().http.dictionary;
+	}
+
+	/**
+	    \brief Check if finished collector blocks are posted before End().
+	*/
+	protected bool IsStream()
+	{
+		return MetricZ_Config.IsLoaded() && MetricZ_Config.Get().http.stream;
+	}
+
+	/**
+	    \brief Check if only changed series are uploaded.
+	*/
+	protected bool IsDelta()
+	{
+		return MetricZ_Config.IsLoaded() && MetricZ_Config.Get().http.delta;
+	}
+
+	/**
+	    \brief Write removal marks of series the backend has but this transaction did not write.
+	    \details `# STALE <series>` for text and JSON payloads, `-<id>` for dictionary payload.
+	*/
+	protected void WriteStale()
+	{
+		if (m_TxnId == string.Empty)
+			return;
+
+		array<string> stale = new array<string>();
+		MetricZ_RestTransactionManager.GetStale(m_TxnId, stale);
+
+		bool dictionary = IsDictionary();
+		foreach (string series : stale) {
+			if (!dictionary) {
+				super.Line("# STALE " + series);
+				continue;
+			}
+
+			int id = MetricZ_RestDictionary.Find(series);
+			if (id >= 0)
+				super.Line("-" + id);
+		}
+	}
+
 	/**
 	    \brief Flushes buffer as a single HTTP request chunk.
 	    \details Registers the chunk with `TransactionManager` to get a sequence ID.
@@ -80,23 +241,50 @@ class MetricZ_RestSink : MetricZ_SinkBase
 	override protected void BufferFlush()
 	{
 		if (m_Client && GetBufferCount() > 0) {
-			int chunkIdx = -1;
-			if (m_TxnId != string.Empty)
-				chunkIdx = MetricZ_RestTransactionManager.AddChunk(m_TxnId);
-
-			MetricZ_CallbackPostMetrics cb = new MetricZ_CallbackPostMetrics(m_Client);
-			if (!cb)
-				ErrorEx("MetricZ: callback not created", ErrorExSeverity.ERROR);
-			else {
-				if (MetricZ_Config.Get().http.serialized)
-					m_Client.PostMetrics(GetJsonBufferChunk(), m_TxnId, chunkIdx, cb);
-				else
-					m_Client.PostMetrics(GetBufferChunk(), m_TxnId, chunkIdx, cb);
-			}
+			if (IsTextBuffer()) {
+				string text = GetBufferChunk();
 
+				// plain text chunk is shared with the recorder, other payloads are recorded in Line()
+				if (!IsDictionary() && !IsDelta() && MetricZ_FlightRecorder.IsRestSource())
+					MetricZ_FlightRecorder.Write(text);
+
+				Post(text);
+			} else {
+				Post(GetJsonBufferChunk());
+			}
 		}
 
 		super.BufferFlush();
 	}
+
+	/**
+	    \brief Post a chunk body as part of the current transaction.
+	    \param payload Chunk body
+	*/
+	protected void Post(string payload)
+	{
+		int chunkIdx = -1;
+		if (m_TxnId != string.Empty)
+			chunkIdx = MetricZ_RestTransactionManager.AddChunk(m_TxnId);
+
+		// transaction was dropped from the window, its chunks would never be committed
+		if (m_TxnId != string.Empty && chunkIdx < 0) {
+			if (IsDictionary())
+				MetricZ_RestDictionary.OnLost(MetricZ_RestDictionary.GetSession());
+
+			return;
+		}
+
+		MetricZ_CallbackPostMetrics cb = new MetricZ_CallbackPostMetrics(m_Client);
+		if (!cb) {
+			ErrorEx("MetricZ: callback not created", ErrorExSeverity.ERROR);
+			return;
+		}
+
+		if (IsDictionary())
+			m_Client.PostMetrics(payload, m_TxnId, chunkIdx, cb, MetricZ_RestDictionary.GetSession());
+		else
+			m_Client.PostMetrics(payload, m_TxnId, chunkIdx, cb);
+	}
 }
 #endif
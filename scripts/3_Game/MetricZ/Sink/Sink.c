@@ -7,11 +7,45 @@
 #ifdef SERVER
 /**
     \brief Solver for create sink
+    \details The sink returned by Get() lives across scrape cycles, it is rebuilt
+             only when the set of active exports changes.
 */
 class MetricZ_Sink
 {
+	protected static ref MetricZ_SinkBase s_Sink; //!< Sink reused by scrape cycles
+	protected static int s_Exports = -1; //!< Exports of s_Sink, bit 1 file, bit 2 http
+
+	/**
+	    \brief Get the sink for a scrape cycle.
+	    \details A sink left busy by an aborted cycle (e.g. failed Begin()) is replaced.
+	    \return \p MetricZ_SinkBase or null
+	*/
+	static MetricZ_SinkBase Get()
+	{
+		if (!MetricZ_Config.IsLoaded())
+			return null;
+
+		MetricZ_ConfigDTO cfg = MetricZ_Config.Get();
+
+		int exports = 0;
+		if (cfg.file.enabled)
+			exports |= 1;
+
+		if (cfg.http.enabled && MetricZ_RestBreaker.IsClosed())
+			exports |= 2;
+
+		if (s_Sink && exports == s_Exports && !s_Sink.IsBusy())
+			return s_Sink;
+
+		s_Sink = New();
+		s_Exports = exports;
+
+		return s_Sink;
+	}
+
 	/**
 	    \brief Create new sink based on configuration
+	    \details REST export is left out while `MetricZ_RestBreaker` is not closed.
 	*/
 	static MetricZ_SinkBase New()
 	{
@@ -23,20 +57,25 @@ class MetricZ_Sink
 			return null;
 
 		MetricZ_SinkBase sink;
+		bool http = (cfg.http.enabled && MetricZ_RestBreaker.IsClosed());
 
-		if (cfg.file.enabled && cfg.http.enabled) {
+		if (cfg.file.enabled && http) {
 			MetricZ_CompositeSink composite = new MetricZ_CompositeSink();
 			if (!composite)
 				return null;
 
-			ErrorEx("MetricZ: do not use both exports in production (file.enabled=1, http.enabled=1)", ErrorExSeverity.WARNING);
+			ErrorEx("MetricZ: both exports are enabled (file.enabled=1, http.enabled=1)", ErrorExSeverity.INFO);
 
 			composite.AddSink(new MetricZ_RestSink(), cfg.http.buffer);
-			composite.AddSink(new MetricZ_FileSink(), cfg.file.buffer);
+			if (MetricZ_SnapshotSink.IsEnabled())
+				composite.AddSink(new MetricZ_SnapshotSink(), 0);
+			else
+				composite.AddSink(new MetricZ_FileSink(), cfg.file.buffer);
+
 			return composite;
 		}
 
-		if (cfg.http.enabled) {
+		if (http) {
 			sink = new MetricZ_RestSink();
 			if (!sink)
 				return null;
@@ -45,6 +84,10 @@ class MetricZ_Sink
 			return sink;
 		}
 
+		// values are written raw, lines are not buffered
+		if (cfg.file.enabled && MetricZ_SnapshotSink.IsEnabled())
+			return new MetricZ_SnapshotSink();
+
 		if (cfg.file.enabled) {
 			sink = new MetricZ_FileSink();
 			if (!sink)
@@ -5,6 +5,13 @@
 */
 
 #ifdef SERVER
+/** Encoding of chunks a sink accepts from `MetricZ_CompositeSink` */
+enum MetricZ_ChunkEncoding {
+	NONE = 0, //!< Sink needs every line
+	TEXT = 1, //!< Newline terminated Prometheus text
+	JSON = 2 //!< JSON array of lines
+}
+
 /**
     \brief Abstract base class for metric sinks.
     \details Implements common state management (Busy/Idle) and string buffering logic.
@@ -15,7 +22,9 @@ class MetricZ_SinkBase
 	private int m_BufferLimit; //!< Buffer limit for the sink
 	private bool m_IsBuffered; //!< Buffered state of the sink
 	private bool m_Busy; //!< Busy state of the sink
-	private ref array<string> m_Buffer; //!< Buffer for the sink
+	private bool m_ChunkFed; //!< Fed with ready chunks by MetricZ_CompositeSink, takes no buffer
+	private ref array<string> m_Buffer; //!< Line buffer for JSON encoding, taken from MetricZ_BufferPool between Begin and End
+	private ref MetricZ_TextBuilder m_Text; //!< Text buffer for Prometheus text encoding, taken from MetricZ_BufferPool between Begin and End
 
 	private static ref JsonSerializer s_Serializer;
 
@@ -32,6 +41,8 @@ class MetricZ_SinkBase
 	        - 0 - No buffering (flush every line immediately).
 	        - > 0 - Buffered (flush automatically when the limit is reached).
 	        - < 0 - Unlimited buffer (flush only on End() or manual call).
+	           In every Begin() text sinks (see IsTextBuffer()) take a MetricZ_TextBuilder,
+	           others an array of lines for GetJsonBufferChunk() from MetricZ_BufferPool.
 	    \param bufferLimit Buffer limit for the sink
 	*/
 	void SetBuffer(int bufferLimit)
@@ -39,14 +50,18 @@ class MetricZ_SinkBase
 		if (bufferLimit != 0) {
 			m_BufferLimit = bufferLimit;
 			m_IsBuffered = true;
-			m_Buffer = new array<string>();
-			if (bufferLimit > 0)
-				m_Buffer.Reserve(bufferLimit);
-			else
-				m_Buffer.Reserve(MetricZ_Constants.SINK_BUFFER_PREALLOC);
 		}
 	}
 
+	/**
+	    \brief Mark the sink as fed by MetricZ_CompositeSink with Chunk() only.
+	    \details Such a sink never buffers lines itself, so Begin() takes no buffer from the pool.
+	*/
+	void SetChunkFed()
+	{
+		m_ChunkFed = true;
+	}
+
 	/**
 	    \brief Prepare the sink for writing a new batch of metrics (transaction start).
 	    \details Clears previous buffers and sets the busy state.
@@ -60,6 +75,15 @@ class MetricZ_SinkBase
 		BufferFlush();
 		m_Busy = true;
 
+		if (m_IsBuffered && !m_ChunkFed) {
+			if (IsTextBuffer()) {
+				if (!m_Text)
+					m_Text = MetricZ_BufferPool.AcquireText();
+			} else if (!m_Buffer) {
+				m_Buffer = MetricZ_BufferPool.Acquire();
+			}
+		}
+
 #ifdef DIAG
 		ErrorEx("MetricZ: sink: begin", ErrorExSeverity.INFO);
 #endif
@@ -92,6 +116,8 @@ class MetricZ_SinkBase
 		BufferFlush();
 		m_Busy = false;
 
+		ReleaseBuffers();
+
 #ifdef DIAG
 		ErrorEx("MetricZ: sink: end", ErrorExSeverity.INFO);
 #endif
@@ -99,6 +125,102 @@ class MetricZ_SinkBase
 		return true;
 	}
 
+	/**
+	    \brief Drop the unfinished batch without writing it (e.g. shutdown in the middle of a cycle).
+	    \details Buffered lines are discarded and the busy state is reset, sinks release their
+	             files or transactions without publishing partial data.
+	*/
+	void Abort()
+	{
+		if (!IsBusy())
+			return;
+
+		ReleaseBuffers();
+		m_Busy = false;
+
+#ifdef DIAG
+		ErrorEx("MetricZ: sink: abort", ErrorExSeverity.INFO);
+#endif
+	}
+
+	/**
+	    \brief Check if the sink takes sample values before they are rendered into lines.
+	    \details Integer and float metrics call SampleInt()/SampleFloat() of such a sink instead of Line(),
+	             headers and other lines still come through Line(). The default is false.
+	*/
+	bool TakesSamples()
+	{
+		return false;
+	}
+
+	/**
+	    \brief Write an integer sample, the default renders it into a line.
+	    \param desc Family descriptor
+	    \param labels Label block with braces
+	    \param value Sample value
+	*/
+	void SampleInt(MetricZ_MetricDescriptor desc, string labels, int value)
+	{
+		Line(string.Format("%1%2 %3", desc.GetName(), labels, value));
+	}
+
+	/**
+	    \brief Write a float sample, the default renders it into a line.
+	    \param desc Family descriptor
+	    \param labels Label block with braces
+	    \param value Sample value
+	*/
+	void SampleFloat(MetricZ_MetricDescriptor desc, string labels, float value)
+	{
+		Line(string.Format("%1%2 %3", desc.GetName(), labels, value));
+	}
+
+	/**
+	    \brief Mark the start of a block of lines written by one collector.
+	    \details Called by the exporter before a collector is flushed or replayed,
+	             sinks may use it to split output by collector, the default does nothing.
+	    \param name Collector name
+	*/
+	void BeginBlock(string name)
+	{
+	}
+
+	/**
+	    \brief Mark the end of a block of lines written by one collector.
+	    \details Called by the exporter between collectors, possibly in different server frames.
+	             Sinks may use it to ship finished blocks early, the default does nothing.
+	*/
+	void EndBlock()
+	{
+	}
+
+	/**
+	    \brief Encoding of ready chunks this sink can take instead of single lines.
+	    \details `MetricZ_CompositeSink` buffers lines once for all sinks that accept chunks
+	             and encodes each chunk once per encoding. Sinks that transform lines return NONE (default).
+	*/
+	MetricZ_ChunkEncoding GetChunkEncoding()
+	{
+		return MetricZ_ChunkEncoding.NONE;
+	}
+
+	/**
+	    \brief Write a chunk encoded by `MetricZ_CompositeSink`.
+	    \param payload Chunk in the encoding of GetChunkEncoding()
+	*/
+	void Chunk(string payload)
+	{
+	}
+
+	/**
+	    \brief Check if the shared buffer may be written at the end of a collector block.
+	    \param lines Number of buffered lines
+	*/
+	bool IsBlockFlushDue(int lines)
+	{
+		return true;
+	}
+
 	/**
 	    \brief Check if the sink is currently processing a batch (between Begin and End).
 	*/
@@ -112,7 +234,7 @@ class MetricZ_SinkBase
 	*/
 	bool IsBuffered()
 	{
-		return (m_IsBuffered && m_Buffer);
+		return m_IsBuffered;
 	}
 
 	/**
@@ -132,22 +254,34 @@ class MetricZ_SinkBase
 		if (!IsBuffered())
 			return -1;
 
-		return m_Buffer.Count();
+		if (m_Text)
+			return m_Text.Count();
+
+		if (m_Buffer)
+			return m_Buffer.Count();
+
+		return 0;
 	}
 
 	/**
 	    \brief Combine all buffered lines into a single string chunk.
-	    \details Joins the array elements with newline characters (\n).
+	    \details Every line is terminated with newline character (\n).
 	    \return string The complete buffered text.
 	*/
 	string GetBufferChunk()
 	{
-		if (!IsBuffered() || m_Buffer.Count() == 0)
+		if (GetBufferCount() <= 0)
 			return string.Empty;
 
-		string chunk;
+		if (m_Text)
+			return m_Text.Join();
+
+		MetricZ_TextBuilder text = MetricZ_BufferPool.AcquireText();
 		foreach (string line : m_Buffer)
-			chunk += string.Format("%1\n", line);
+			text.Append(line);
+
+		string chunk = text.Join();
+		MetricZ_BufferPool.ReleaseText(text);
 
 		return chunk;
 	}
@@ -158,7 +292,7 @@ class MetricZ_SinkBase
 	*/
 	string GetJsonBufferChunk()
 	{
-		if (!IsBuffered() || m_Buffer.Count() == 0)
+		if (!m_Buffer || m_Buffer.Count() == 0)
 			return string.Empty;
 
 		string json;
@@ -183,12 +317,42 @@ class MetricZ_SinkBase
 		if (!IsBusy() || !IsBuffered())
 			return;
 
-		m_Buffer.Insert(line);
+		if (m_Text)
+			m_Text.Append(line);
+		else if (m_Buffer)
+			m_Buffer.Insert(line);
 
-		if (m_Buffer.Count() >= m_BufferLimit && m_BufferLimit > 0)
+		if (m_BufferLimit > 0 && GetBufferCount() >= m_BufferLimit)
 			BufferFlush();
 	}
 
+	/**
+	    \brief Select text buffer encoding.
+	    \details Text sinks build the chunk directly, without keeping an array of single lines.
+	             Override to return false for sinks sending lines through GetJsonBufferChunk().
+	    \return bool True for text buffer (default).
+	*/
+	protected bool IsTextBuffer()
+	{
+		return true;
+	}
+
+	/**
+	    \brief Return buffers to MetricZ_BufferPool, unwritten lines are dropped.
+	*/
+	protected void ReleaseBuffers()
+	{
+		if (m_Text) {
+			MetricZ_BufferPool.ReleaseText(m_Text);
+			m_Text = null;
+		}
+
+		if (m_Buffer) {
+			MetricZ_BufferPool.Release(m_Buffer);
+			m_Buffer = null;
+		}
+	}
+
 	/**
 	    \brief Clear the buffer memory.
 	    \details Derived classes must override this to write/send data before clearing.
@@ -196,8 +360,13 @@ class MetricZ_SinkBase
 	*/
 	protected void BufferFlush()
 	{
-		if (IsBuffered())
+		if (m_Text)
+			m_Text.Clear();
+
+		if (m_Buffer) {
+			MetricZ_BufferPool.Observe(m_Buffer.Count());
 			m_Buffer.Clear();
+		}
 	}
 }
 #endif
@@ -0,0 +1,378 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Sink writing binary snapshots with FileSerializer.
+    \details Instead of a .prom file every cycle is appended to a snapshot segment
+             `<file>_<epoch>.snap` in the export directory, `tools/snapshot.py` converts it
+             to Prometheus text or OpenMetrics. Segment layout, every record starts with an int tag:
+               - header: `MZSNAP` string, int version
+               - `TAG_FAMILY`: HELP/TYPE line, once per segment
+               - `TAG_SERIES`: int id, series name with labels, once per segment
+               - `TAG_CYCLE`: int epoch, int count and (int id, int value) pairs,
+                 int count and (int id, float value) pairs, int count and (int id, string value) pairs
+             Integer and float metrics hand their values over before rendering (see TakesSamples()),
+             series are looked up by family id and label block, only other lines are parsed.
+             A segment is closed after `MetricZ_Constants.SNAPSHOT_SEGMENT_SIZE` written bytes,
+             `file.snapshot_segments` newest segments are kept.
+*/
+class MetricZ_SnapshotSink : MetricZ_SinkBase
+{
+	static const string MAGIC = "MZSNAP"; //!< Segment header
+	static const int VERSION = 1; //!< Segment format version
+	static const int TAG_FAMILY = 1; //!< Family table record
+	static const int TAG_SERIES = 2; //!< Series table record
+	static const int TAG_CYCLE = 3; //!< Values of one cycle
+
+	private ref FileSerializer m_File; //!< Segment open between Begin and End
+
+	private ref array<int> m_IntIds = new array<int>(); //!< Series of integer values in this cycle
+	private ref array<int> m_IntValues = new array<int>(); //!< Integer values in this cycle
+	private ref array<int> m_FloatIds = new array<int>(); //!< Series of float values in this cycle
+	private ref array<float> m_FloatValues = new array<float>(); //!< Float values in this cycle
+	private ref array<int> m_TextIds = new array<int>(); //!< Series of values kept as text (NaN, Inf)
+	private ref array<string> m_TextValues = new array<string>(); //!< Values kept as text in this cycle
+	private int m_CycleBytes; //!< Bytes written in this cycle
+	private bool m_Record; //!< Samples are also rendered for MetricZ_FlightRecorder
+
+	private static string s_Segment; //!< Segment written in this session
+	private static int s_SegmentBytes; //!< Bytes written into s_Segment
+	private static int s_SeriesCount; //!< Series ids used in s_Segment
+	private static ref map<string, int> s_Series = new map<string, int>(); //!< Series of parsed lines -> id in s_Segment
+	private static ref array<ref map<string, int>> s_SampleSeries = new array<ref map<string, int>>(); //!< Label block -> id by family id
+	private static ref set<string> s_Families = new set<string>(); //!< HELP/TYPE lines in s_Segment
+
+	/**
+	    \brief Check if the snapshot sink replaces the .prom file.
+	*/
+	static bool IsEnabled()
+	{
+		return MetricZ_Config.IsLoaded() && MetricZ_Config.Get().file.snapshot && MetricZ_Config.Get().file.snapshot_file_prefix != string.Empty;
+	}
+
+	/**
+	    \brief Open the segment, a new one is started when it is missing or full.
+	*/
+	override bool Begin()
+	{
+		if (!IsEnabled())
+			return false;
+
+		if (!super.Begin())
+			return false;
+
+		bool fresh = (s_Segment == string.Empty || s_SegmentBytes >= MetricZ_Constants.SNAPSHOT_SEGMENT_SIZE || !FileExist(s_Segment));
+		if (fresh)
+			NewSegment();
+
+		m_File = new FileSerializer();
+		if (fresh)
+			m_File.Open(s_Segment, FileMode.WRITE);
+		else
+			m_File.Open(s_Segment, FileMode.APPEND);
+
+		if (!m_File.IsOpen()) {
+			ErrorEx("MetricZ: open snapshot '" + s_Segment + "' failed", ErrorExSeverity.ERROR);
+			m_File = null;
+			s_Segment = string.Empty;
+			// sink is reused, leave it idle for the next cycle
+			super.End();
+			return false;
+		}
+
+		m_CycleBytes = 0;
+		m_Record = MetricZ_FlightRecorder.IsEnabled();
+
+		if (fresh) {
+			WriteString(MAGIC);
+			WriteInt(VERSION);
+		}
+
+		m_IntIds.Clear();
+		m_IntValues.Clear();
+		m_FloatIds.Clear();
+		m_FloatValues.Clear();
+		m_TextIds.Clear();
+		m_TextValues.Clear();
+
+		return true;
+	}
+
+	/**
+	    \brief Add family or series to the tables and the value to the cycle.
+	    \param line Metric line
+	*/
+	override void Line(string line)
+	{
+		if (!IsBusy() || !m_File || line == string.Empty)
+			return;
+
+		MetricZ_FlightRecorder.Line(line);
+
+		string series, value;
+		MetricZ_RestDictionary.SplitLine(line, series, value);
+
+		if (value == string.Empty) {
+			if (line.IndexOf("#") != 0 || s_Families.Find(line) >= 0)
+				return;
+
+			s_Families.Insert(line);
+			WriteInt(TAG_FAMILY);
+			WriteString(line);
+			return;
+		}
+
+		int id;
+		if (!s_Series.Find(series, id)) {
+			id = NewSeries(series);
+			s_Series.Insert(series, id);
+		}
+
+		int intValue = value.ToInt();
+		if (intValue.ToString() == value) {
+			m_IntIds.Insert(id);
+			m_IntValues.Insert(intValue);
+			return;
+		}
+
+		if (value.IndexOf(".") >= 0 || value.IndexOf("e") >= 0) {
+			m_FloatIds.Insert(id);
+			m_FloatValues.Insert(value.ToFloat());
+			return;
+		}
+
+		// NaN, +Inf, -Inf and integers above int range are kept as written
+		m_TextIds.Insert(id);
+		m_TextValues.Insert(value);
+	}
+
+	/**
+	    \brief Take sample values of integer and float metrics, no line is rendered or parsed.
+	*/
+	override bool TakesSamples()
+	{
+		return true;
+	}
+
+	/**
+	    \brief Add an integer sample to the cycle.
+	    \param desc Family descriptor
+	    \param labels Label block with braces
+	    \param value Sample value
+	*/
+	override void SampleInt(MetricZ_MetricDescriptor desc, string labels, int value)
+	{
+		if (!IsBusy() || !m_File)
+			return;
+
+		if (m_Record)
+			MetricZ_FlightRecorder.Line(string.Format("%1%2 %3", desc.GetName(), labels, value));
+
+		m_IntIds.Insert(SampleSeries(desc, labels));
+		m_IntValues.Insert(value);
+	}
+
+	/**
+	    \brief Add a float sample to the cycle.
+	    \param desc Family descriptor
+	    \param labels Label block with braces
+	    \param value Sample value
+	*/
+	override void SampleFloat(MetricZ_MetricDescriptor desc, string labels, float value)
+	{
+		if (!IsBusy() || !m_File)
+			return;
+
+		if (m_Record)
+			MetricZ_FlightRecorder.Line(string.Format("%1%2 %3", desc.GetName(), labels, value));
+
+		m_FloatIds.Insert(SampleSeries(desc, labels));
+		m_FloatValues.Insert(value);
+	}
+
+	/**
+	    \brief Write values of the cycle and close the segment.
+	*/
+	override bool End()
+	{
+		if (!super.End())
+			return false;
+
+		if (!m_File)
+			return false;
+
+		WriteInt(TAG_CYCLE);
+		WriteInt(MetricZ_Time.EpochSecondsUTC());
+
+		int count = m_IntIds.Count();
+		WriteInt(count);
+		for (int i = 0; i < count; i++) {
+			WriteInt(m_IntIds[i]);
+			WriteInt(m_IntValues[i]);
+		}
+
+		count = m_FloatIds.Count();
+		WriteInt(count);
+		for (int f = 0; f < count; f++) {
+			WriteInt(m_FloatIds[f]);
+			WriteFloat(m_FloatValues[f]);
+		}
+
+		count = m_TextIds.Count();
+		WriteInt(count);
+		for (int t = 0; t < count; t++) {
+			WriteInt(m_TextIds[t]);
+			WriteString(m_TextValues[t]);
+		}
+
+		m_File.Close();
+		m_File = null;
+
+		MetricZ_FileSink.AddWrittenBytes(m_CycleBytes);
+		MetricZ_FileSink.EndCycle();
+
+		return true;
+	}
+
+	/**
+	    \brief Close the segment without the cycle record.
+	    \details Table records already written stay valid, the unfinished cycle is not stored.
+	*/
+	override void Abort()
+	{
+		if (!IsBusy())
+			return;
+
+		if (m_File) {
+			m_File.Close();
+			m_File = null;
+		}
+
+		super.Abort();
+	}
+
+	/**
+	    \brief Get the id of a sampled series, the series record is written on first use.
+	    \param desc Family descriptor
+	    \param labels Label block with braces
+	    \return \p int Series id in the segment
+	*/
+	protected int SampleSeries(MetricZ_MetricDescriptor desc, string labels)
+	{
+		int family = desc.GetId();
+		if (family >= s_SampleSeries.Count())
+			s_SampleSeries.Resize(family + 1);
+
+		map<string, int> table = s_SampleSeries[family];
+		if (!table) {
+			table = new map<string, int>();
+			s_SampleSeries[family] = table;
+		}
+
+		int id;
+		if (!table.Find(labels, id)) {
+			id = NewSeries(desc.GetName() + labels);
+			table.Insert(labels, id);
+		}
+
+		return id;
+	}
+
+	/**
+	    \brief Write the series record of a new id.
+	    \param series Series name with labels
+	    \return \p int New series id
+	*/
+	protected int NewSeries(string series)
+	{
+		int id = s_SeriesCount;
+		s_SeriesCount++;
+
+		WriteInt(TAG_SERIES);
+		WriteInt(id);
+		WriteString(series);
+
+		return id;
+	}
+
+	/**
+	    \brief Write an int, FileSerializer stores 4 bytes.
+	*/
+	protected void WriteInt(int value)
+	{
+		m_File.Write(value);
+		AddBytes(4);
+	}
+
+	/**
+	    \brief Write a float, FileSerializer stores 4 bytes.
+	*/
+	protected void WriteFloat(float value)
+	{
+		m_File.Write(value);
+		AddBytes(4);
+	}
+
+	/**
+	    \brief Write a string, FileSerializer stores an int length and the bytes.
+	*/
+	protected void WriteString(string value)
+	{
+		m_File.Write(value);
+		AddBytes(4 + value.Length());
+	}
+
+	/**
+	    \brief Account written bytes to the cycle and the segment.
+	*/
+	protected void AddBytes(int bytes)
+	{
+		m_CycleBytes += bytes;
+		s_SegmentBytes += bytes;
+	}
+
+	/**
+	    \brief Start a new segment, tables are written again into it.
+	    \details Oldest segments of this instance above `file.snapshot_segments` are deleted.
+	*/
+	protected static void NewSegment()
+	{
+		string prefix = MetricZ_Config.Get().file.snapshot_file_prefix;
+		s_Segment = string.Format("%1%2.snap", prefix, MetricZ_Time.EpochSecondsUTC().ToStringLen(10));
+		s_SegmentBytes = 0;
+		s_SeriesCount = 0;
+		s_Series.Clear();
+		s_SampleSeries.Clear();
+		s_Families.Clear();
+
+		array<string> files = new array<string>();
+		string name;
+		FileAttr attr;
+		FindFileHandle handle = FindFile(prefix + "*.snap", name, attr, FindFileFlags.ALL);
+		if (handle) {
+			bool found = true;
+			while (found) {
+				if (name != string.Empty)
+					files.Insert(MetricZ_Constants.EXPORT_DIR + name);
+
+				found = FindNextFile(handle, name, attr);
+			}
+
+			CloseFindFile(handle);
+		}
+
+		if (files.Find(s_Segment) < 0)
+			files.Insert(s_Segment);
+
+		files.Sort();
+
+		int excess = files.Count() - MetricZ_Config.Get().file.snapshot_segments;
+		for (int i = 0; i < excess; i++)
+			DeleteFile(files[i]);
+	}
+}
+#endif
@@ -11,54 +11,39 @@
 class MetricZ_EventStats
 {
 	protected static ref map<EventType, string> s_EventNames; //!< Map of EventType to name
-	protected static ref map<EventType, int> s_EventsRegistry = new map<EventType, int>(); //!< Map of EventType to count
 
 	// Metric: Total events by EventType
-	protected static ref MetricZ_MetricInt s_EventTotal = new MetricZ_MetricInt(
+	protected static ref MetricZ_MetricVector s_EventTotal = MetricZ_MetricVector.Create(
 	    "events",
 	    "Total events by EventType",
-	    MetricZ_MetricType.COUNTER);
+	    MetricZ_MetricType.COUNTER,
+	    "id",
+	    "event");
 
 	/**
 	    \brief Increment counter for an EventType.
+	    \details Event name label is resolved only when the series is created.
 	    \param eventTypeId Engine event id.
 	*/
 	static void Inc(EventType eventTypeId)
 	{
-		int v;
-		if (s_EventsRegistry.Find(eventTypeId, v))
-			s_EventsRegistry.Set(eventTypeId, v + 1);
-		else
-			s_EventsRegistry.Insert(eventTypeId, 1);
+		int slot = s_EventTotal.FindId(eventTypeId);
+		if (slot < 0) {
+			MakeNameMap();
+			slot = s_EventTotal.SlotId(eventTypeId, EventName(eventTypeId));
+		}
+
+		s_EventTotal.Inc(slot);
 	}
 
 	/**
 	    \brief Emit HELP/TYPE and per-event samples.
-	    \details Builds the EventType->name map lazily.
-	             Writes one sample per EventType with labels `{id, event}`.
+	    \details Writes one sample per EventType with labels `{id, event}`.
 	    \param sink MetricZ_SinkBase metric sink instance
 	*/
 	static void Flush(MetricZ_SinkBase sink)
 	{
-		if (!sink || s_EventsRegistry.Count() == 0)
-			return;
-
-		MakeNameMap();
-		s_EventTotal.WriteHeaders(sink);
-
-		for (int i = 0; i < s_EventsRegistry.Count(); ++i) {
-			int id = s_EventsRegistry.GetKey(i);
-			int val = s_EventsRegistry.GetElement(i);
-
-			s_EventTotal.Set(val);
-
-			string name = EventName(s_EventsRegistry.GetKey(i));
-			map<string, string> labels = new map<string, string>();
-			labels.Insert("id", id.ToString());
-			labels.Insert("event", name);
-
-			s_EventTotal.Flush(sink, MetricZ_LabelUtils.MakeLabels(labels));
-		}
+		s_EventTotal.FlushWithHead(sink);
 	}
 
 	/**
@@ -10,13 +10,12 @@
 */
 class MetricZ_RpcStats
 {
-	protected static ref map<int, int> s_InputRPCsRegistry = new map<int, int>(); //!< Map of RPC type to count
-
-	// Metric: Total input RPC calls
-	protected static ref MetricZ_MetricInt s_RpcTotal = new MetricZ_MetricInt(
+	// Metric: Total input RPC calls by RPC id
+	protected static ref MetricZ_MetricVector s_RpcTotal = MetricZ_MetricVector.Create(
 	    "rpc_input",
 	    "Total input RPC calls",
-	    MetricZ_MetricType.COUNTER);
+	    MetricZ_MetricType.COUNTER,
+	    "id");
 
 	/**
 	    \brief Increment counter for an RPC type.
@@ -24,39 +23,18 @@ class MetricZ_RpcStats
 	*/
 	static void Inc(int rpc_type)
 	{
-		int v;
-		if (s_InputRPCsRegistry.Find(rpc_type, v))
-			s_InputRPCsRegistry.Set(rpc_type, v + 1);
-		else
-			s_InputRPCsRegistry.Insert(rpc_type, 1);
+		s_RpcTotal.Inc(s_RpcTotal.SlotId(rpc_type));
 	}
 
 	/**
 	    \brief Emit HELP/TYPE and per-RPC samples.
-	    \details Uses the in-memory registry and writes one sample per rpc_type with label {id="<id>"}.
+	    \details Writes one sample per rpc_type with label {id="<id>"}.
 	              Headers written once per family.
 	    \param sink MetricZ_SinkBase instance
 	*/
 	static void Flush(MetricZ_SinkBase sink)
 	{
-		if (!sink || s_InputRPCsRegistry.Count() == 0)
-			return;
-
-		// headers once
-		s_RpcTotal.WriteHeaders(sink);
-
-		// emit per id
-		for (int i = 0; i < s_InputRPCsRegistry.Count(); ++i) {
-			int id = s_InputRPCsRegistry.GetKey(i);
-			int val = s_InputRPCsRegistry.GetElement(i);
-
-			s_RpcTotal.Set(val);
-
-			map<string, string> labels = new map<string, string>();
-			labels.Insert("id", id.ToString());
-
-			s_RpcTotal.Flush(sink, MetricZ_LabelUtils.MakeLabels(labels));
-		}
+		s_RpcTotal.FlushWithHead(sink);
 	}
 }
 #endif
@@ -6,9 +6,11 @@
 
 #ifdef SERVER
 /**
-    \brief Lightweight 1-second FPS sampler.
+    \brief Lightweight 1-second FPS sampler and frame time recorder.
     \details Accumulates frame count and elapsed time via MissionServer::OnUpdate(timeslice)
              and computes average FPS once per ~1s window.
+             Every frame time is also recorded into a histogram, counted against hitch thresholds
+             and compared to the longest frame of the scrape window, all in constant time per frame.
 */
 class MetricZ_FrameMonitor
 {
@@ -23,6 +25,41 @@ class MetricZ_FrameMonitor
 	static int s_WindowCount; //!< Number of FPS samples in window
 	static bool s_WindowHasSample; //!< True if the window has a sample
 
+	// frame times
+	static ref MetricZ_MetricHistogram s_FrameTime; //!< Frame time histogram since start, exported
+	static ref array<int> s_WindowBaseline = new array<int>(); //!< s_FrameTime buckets at window start, for quantiles
+	static float s_WindowLongest; //!< Longest frame in window, seconds
+	static ref array<float> s_HitchThresholds = new array<float>(); //!< Ascending hitch thresholds, seconds
+	static ref array<int> s_HitchCounts = new array<int>(); //!< Frames over each threshold since start
+
+	/**
+	    \brief Set up frame time histogram and hitch thresholds.
+	    \param thresholdsMs Ascending hitch thresholds in milliseconds
+	*/
+	static void Init(array<int> thresholdsMs)
+	{
+		if (s_FrameTime)
+			return;
+
+		array<float> bounds = {0.005, 0.01, 0.0167, 0.025, 0.033, 0.05, 0.075, 0.1, 0.15, 0.25, 0.5, 1.0, 2.5, 5.0};
+
+		s_FrameTime = new MetricZ_MetricHistogram(
+		    "frame_time_seconds",
+		    "Server frame time distribution, seconds",
+		    MetricZ_MetricType.HISTOGRAM);
+		s_FrameTime.SetBounds(bounds);
+		s_FrameTime.CopyBuckets(s_WindowBaseline);
+
+		s_HitchThresholds.Clear();
+		s_HitchCounts.Clear();
+		if (thresholdsMs) {
+			foreach (int ms : thresholdsMs) {
+				s_HitchThresholds.Insert(ms * 0.001);
+				s_HitchCounts.Insert(0);
+			}
+		}
+	}
+
 	/**
 	    \brief Feed per-frame timing and update the rolling 1s FPS.
 	    \param timeslice Delta time of the last frame in seconds.
@@ -33,6 +70,22 @@ class MetricZ_FrameMonitor
 		s_AccTime += timeslice;
 		s_AccFrames++;
 
+		if (s_FrameTime) {
+			s_FrameTime.Observe(timeslice);
+
+			if (timeslice > s_WindowLongest)
+				s_WindowLongest = timeslice;
+
+			// thresholds are ascending, stop at the first one not exceeded
+			int hitches = s_HitchThresholds.Count();
+			for (int i = 0; i < hitches; i++) {
+				if (timeslice <= s_HitchThresholds[i])
+					break;
+
+				s_HitchCounts[i] = s_HitchCounts[i] + 1;
+			}
+		}
+
 		if (s_AccTime >= 1.0) {
 			if (s_AccTime > 0)
 				s_FPS = s_AccFrames / s_AccTime;
@@ -97,6 +150,33 @@ class MetricZ_FrameMonitor
 		s_WindowHasSample = false;
 	}
 
+	/**
+	    \brief Snapshot and reset frame time window stats.
+	    \param[out] p50 Median frame time in window, seconds
+	    \param[out] p95 95th percentile frame time in window, seconds
+	    \param[out] p99 99th percentile frame time in window, seconds
+	    \param[out] longest Longest frame in window, seconds
+	*/
+	static void SnapshotFrameTimes(out float p50, out float p95, out float p99, out float longest)
+	{
+		if (!s_FrameTime) {
+			p50 = 0;
+			p95 = 0;
+			p99 = 0;
+			longest = 0;
+			return;
+		}
+
+		p50 = s_FrameTime.Quantile(0.5, s_WindowBaseline);
+		p95 = s_FrameTime.Quantile(0.95, s_WindowBaseline);
+		p99 = s_FrameTime.Quantile(0.99, s_WindowBaseline);
+		longest = s_WindowLongest;
+
+		// reset window
+		s_FrameTime.CopyBuckets(s_WindowBaseline);
+		s_WindowLongest = 0;
+	}
+
 	/**
 	    \brief Return the last computed 1s average FPS.
 	    \return Average FPS sampled over the last completed ~1s window; 0 if not computed yet.
@@ -58,6 +58,7 @@ class MetricZ_LabelUtils
 	    \details Auto-includes base labels {world, host, instance_id}.
 	             Merges user labels without overwriting base keys.
 	             Skips empty world/host. Order is unspecified.
+	             For fixed keys prefer MetricZ_LabelSchema, it skips the map and key normalization.
 	    \param labels Optional map of extra key->value pairs
 	    \return \p string Prometheus label block, e.g. `{k="v",...}`
 	*/
@@ -172,7 +173,7 @@ class MetricZ_LabelUtils
 	    \param key Normalized label key
 	    \return \p bool True if the key must not be accepted
 	*/
-	private static bool IsDenied(string key)
+	static bool IsDenied(string key)
 	{
 		InitDenyLabels();
 
@@ -202,7 +203,7 @@ class MetricZ_LabelUtils
 		// Prometheus reserved labels
 		s_DenyLabels.Insert("job", true);
 		s_DenyLabels.Insert("instance", true);
-		// For future histogram buckets and summaries
+		// Histogram buckets and summaries
 		s_DenyLabels.Insert("le", true);
 		s_DenyLabels.Insert("quantile", true);
 	}
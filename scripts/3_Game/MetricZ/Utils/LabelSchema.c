@@ -0,0 +1,155 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Fixed set of label keys declared once.
+    \details Keys are normalized and validated when the schema is declared,
+             Render() appends positional values to the cached base label fragment
+             without a map and without per-key normalization.
+             Empty values are skipped, same as in MetricZ_LabelUtils::MakeLabels().
+    \param keys Comma separated label keys, e.g. "class,type,hash"
+*/
+class MetricZ_LabelSchema
+{
+	static const int MAX_KEYS = 8; //!< Max number of keys in one schema
+
+	protected ref array<string> m_Keys = new array<string>(); //!< Normalized keys
+	protected ref array<string> m_Prefixes = new array<string>(); //!< Rendered `,key="` by position, empty if key was rejected
+
+	/**
+	    \brief Constructor.
+	    \param keys Comma separated label keys
+	*/
+	void MetricZ_LabelSchema(string keys = "")
+	{
+		if (keys == string.Empty)
+			return;
+
+		array<string> parts = new array<string>();
+		keys.Split(",", parts);
+
+		foreach (string key : parts)
+			AddKey(key);
+	}
+
+	/**
+	    \brief Append key to the schema.
+	    \details Key is trimmed, lowercased, spaces are replaced by `_`.
+	             Denied or malformed keys keep their position but are never rendered.
+	    \param key Label key
+	*/
+	void AddKey(string key)
+	{
+		if (m_Keys.Count() >= MAX_KEYS) {
+			ErrorEx("MetricZ: label schema supports up to " + MAX_KEYS + " keys, skip " + key, ErrorExSeverity.WARNING);
+			return;
+		}
+
+		key.TrimInPlace();
+		key.ToLower();
+		key.Replace(" ", "_");
+
+		m_Keys.Insert(key);
+
+		if (!IsValidKey(key) || MetricZ_LabelUtils.IsDenied(key)) {
+			ErrorEx("MetricZ: label key \"" + key + "\" is not allowed", ErrorExSeverity.WARNING);
+			m_Prefixes.Insert(string.Empty);
+			return;
+		}
+
+		m_Prefixes.Insert(string.Format(",%1=\"", key));
+	}
+
+	/**
+	    \brief Number of keys.
+	*/
+	int Count()
+	{
+		return m_Keys.Count();
+	}
+
+	/**
+	    \brief Get normalized key by position.
+	*/
+	string GetKey(int idx)
+	{
+		return m_Keys[idx];
+	}
+
+	/**
+	    \brief Render label block with base labels and positional values.
+	    \details Values beyond Count() are ignored, values are trimmed and escaped.
+	    \return \p string Prometheus label block, e.g. `{world="...",...,k="v"}`
+	*/
+	string Render(string v1 = "", string v2 = "", string v3 = "", string v4 = "", string v5 = "", string v6 = "", string v7 = "", string v8 = "")
+	{
+		string result = "{" + MetricZ_LabelUtils.BaseLabels();
+
+		int count = m_Prefixes.Count();
+		if (count > 0)
+			result += Value(0, v1);
+		if (count > 1)
+			result += Value(1, v2);
+		if (count > 2)
+			result += Value(2, v3);
+		if (count > 3)
+			result += Value(3, v4);
+		if (count > 4)
+			result += Value(4, v5);
+		if (count > 5)
+			result += Value(5, v6);
+		if (count > 6)
+			result += Value(6, v7);
+		if (count > 7)
+			result += Value(7, v8);
+
+		return result + "}";
+	}
+
+	/**
+	    \brief Render one `,key="value"` pair.
+	    \return \p string Pair or empty string for empty value or rejected key
+	*/
+	protected string Value(int idx, string value)
+	{
+		if (value == string.Empty || m_Prefixes[idx] == string.Empty)
+			return string.Empty;
+
+		value.TrimInPlace();
+		if (value == string.Empty)
+			return string.Empty;
+
+		return m_Prefixes[idx] + MetricZ_LabelUtils.Escape(value) + "\"";
+	}
+
+	/**
+	    \brief Check label name syntax `[a-z_][a-z0-9_]*` of a lowercased key.
+	    \param key Normalized key
+	    \return \p bool
+	*/
+	protected static bool IsValidKey(string key)
+	{
+		int len = key.Length();
+		if (len == 0)
+			return false;
+
+		for (int i = 0; i < len; i++) {
+			int c = key.Get(i).ToAscii();
+
+			if (c == 95 || (c >= 97 && c <= 122))
+				continue;
+
+			if (i > 0 && c >= 48 && c <= 57)
+				continue;
+
+			return false;
+		}
+
+		return true;
+	}
+}
+#endif
@@ -0,0 +1,110 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Segmented builder for newline separated text.
+    \details Appending to one growing string copies it on every `+=`, which is quadratic in the payload size.
+             Lines are appended into a small segment of SEGMENT_LINES lines, full segments are stored
+             and Join() merges neighbour segments pairwise, so every byte is copied O(log n) times.
+*/
+class MetricZ_TextBuilder
+{
+	static const int SEGMENT_LINES = 64; //!< Lines per segment
+
+	protected string m_Segment; //!< Open segment
+	protected int m_SegmentLines; //!< Lines in the open segment
+	protected int m_Lines; //!< Total lines appended since Clear()
+	protected ref array<string> m_Segments = new array<string>(); //!< Closed segments
+
+	/**
+	    \brief Append line with trailing newline.
+	    \param line Text line without newline
+	*/
+	void Append(string line)
+	{
+		m_Segment += line + "\n";
+		m_SegmentLines++;
+		m_Lines++;
+
+		if (m_SegmentLines >= SEGMENT_LINES)
+			CloseSegment();
+	}
+
+	/**
+	    \brief Reserve the segment list for a number of lines.
+	    \param lines Expected lines
+	*/
+	void Reserve(int lines)
+	{
+		m_Segments.Reserve(lines / SEGMENT_LINES + 1);
+	}
+
+	/**
+	    \brief Number of lines appended since Clear().
+	*/
+	int Count()
+	{
+		return m_Lines;
+	}
+
+	/**
+	    \brief Join all segments into one string.
+	    \details Builder keeps the joined text as its only segment, appending may continue.
+	    \return \p string Text with every line terminated by newline
+	*/
+	string Join()
+	{
+		CloseSegment();
+
+		int count = m_Segments.Count();
+		if (count == 0)
+			return string.Empty;
+
+		while (count > 1) {
+			int w = 0;
+			for (int i = 0; i < count; i += 2) {
+				if (i + 1 < count)
+					m_Segments[w] = m_Segments[i] + m_Segments[i + 1];
+				else
+					m_Segments[w] = m_Segments[i];
+
+				w++;
+			}
+
+			count = w;
+		}
+
+		m_Segments.Resize(1);
+
+		return m_Segments[0];
+	}
+
+	/**
+	    \brief Drop all text.
+	*/
+	void Clear()
+	{
+		m_Segment = string.Empty;
+		m_SegmentLines = 0;
+		m_Lines = 0;
+		m_Segments.Clear();
+	}
+
+	/**
+	    \brief Move open segment into the closed list.
+	*/
+	protected void CloseSegment()
+	{
+		if (m_SegmentLines == 0)
+			return;
+
+		m_Segments.Insert(m_Segment);
+		m_Segment = string.Empty;
+		m_SegmentLines = 0;
+	}
+}
+#endif
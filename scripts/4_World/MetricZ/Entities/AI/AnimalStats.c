@@ -11,13 +11,12 @@
 */
 class MetricZ_AnimalStats
 {
-	protected static ref map<string, int> s_CountByType = new map<string, int>(); // animal -> count
-	protected static ref map<string, string> s_LabelsByType = new map<string, string>(); // animal -> cached labels
-
-	protected static ref MetricZ_MetricInt s_MetricCountByType = new MetricZ_MetricInt(
+	// Metric: Animals count by canonical type.
+	protected static ref MetricZ_MetricVector s_MetricCountByType = MetricZ_MetricVector.Create(
 	    "animals_by_type",
 	    "Animals in world grouped by canonical type",
-	    MetricZ_MetricType.GAUGE);
+	    MetricZ_MetricType.GAUGE,
+	    "animal");
 
 	/**
 	    \brief Increment per-type count for spawned animal.
@@ -28,18 +27,7 @@ class MetricZ_AnimalStats
 			return;
 
 		string type = animal.MetricZ_GetLabelTypeName();
-
-		int v;
-		if (s_CountByType.Find(type, v))
-			s_CountByType.Set(type, v + 1);
-		else {
-			s_CountByType.Insert(type, 1);
-
-			// build labels once per type
-			map<string, string> labels = new map<string, string>();
-			labels.Insert("animal", type);
-			s_LabelsByType.Insert(type, MetricZ_LabelUtils.MakeLabels(labels));
-		}
+		s_MetricCountByType.Inc(s_MetricCountByType.Slot(type));
 	}
 
 	/**
@@ -52,16 +40,12 @@ class MetricZ_AnimalStats
 
 		string type = animal.MetricZ_GetLabelTypeName();
 
-		int v;
-		if (!s_CountByType.Find(type, v))
+		int slot = s_MetricCountByType.Find(type);
+		if (slot < 0)
 			return;
 
-		v = v - 1;
-		if (v <= 0) {
-			s_CountByType.Remove(type);
-			s_LabelsByType.Remove(type);
-		} else
-			s_CountByType.Set(type, v);
+		if (s_MetricCountByType.Add(slot, -1) <= 0)
+			s_MetricCountByType.Remove(slot);
 	}
 
 	/**
@@ -70,28 +54,7 @@ class MetricZ_AnimalStats
 	*/
 	static void Flush(MetricZ_SinkBase sink)
 	{
-		if (!sink)
-			return;
-
-		if (s_CountByType.Count() == 0)
-			return;
-
-		s_MetricCountByType.WriteHeaders(sink);
-
-		foreach (string key, int val : s_CountByType) {
-			s_MetricCountByType.Set(val);
-
-			string labels = s_LabelsByType.Get(key);
-			if (labels == string.Empty) {
-				// safety: rebuild labels if cache was empty
-				map<string, string> tmp = new map<string, string>();
-				tmp.Insert("animal", key);
-				labels = MetricZ_LabelUtils.MakeLabels(tmp);
-				s_LabelsByType.Set(key, labels);
-			}
-
-			s_MetricCountByType.Flush(sink, labels);
-		}
+		s_MetricCountByType.FlushWithHead(sink);
 	}
 }
 #endif
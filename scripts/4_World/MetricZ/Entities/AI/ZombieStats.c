@@ -14,21 +14,21 @@
 class MetricZ_ZombieStats
 {
 	static const int MINDSTATE_DEAD = 1000; //!< Synthetic mind-state id for dead infected
-	protected static ref map<int, int> s_CountByType = new map<int, int>(); //!< State -> current infected count.
 	protected static ref map<int, string> s_MindStates; //!< State -> human-readable name. Built lazily.
-	protected static ref map<string, int> s_TypeStorage = new map<string, int>(); //!< Type -> current infected count.
-	protected static ref map<string, string> s_TypeLabels = new map<string, string>(); //!< Type -> cached labels.
 
 	// Metric: Infected count by mind state.
-	protected static ref MetricZ_MetricInt s_MetricMindState = new MetricZ_MetricInt(
+	protected static ref MetricZ_MetricVector s_MetricMindState = MetricZ_MetricVector.Create(
 	    "infected_mind_state",
 	    "Infected count by mind state",
-	    MetricZ_MetricType.GAUGE);
+	    MetricZ_MetricType.GAUGE,
+	    "state_id",
+	    "state");
 	// Metric: Infected count by zombie type.
-	protected static ref MetricZ_MetricInt s_MetricCountByType = new MetricZ_MetricInt(
+	protected static ref MetricZ_MetricVector s_MetricCountByType = MetricZ_MetricVector.Create(
 	    "infected_by_type",
 	    "Infected count by zombie type",
-	    MetricZ_MetricType.GAUGE);
+	    MetricZ_MetricType.GAUGE,
+	    "type");
 
 	/**
 	    \brief Fill name map once.
@@ -59,11 +59,18 @@ class MetricZ_ZombieStats
 		if (state < 0)
 			return;
 
-		int v;
-		if (s_CountByType.Find(state, v))
-			s_CountByType.Set(state, Math.Max(v + delta, 0));
-		else if (delta > 0)
-			s_CountByType.Insert(state, delta);
+		int slot = s_MetricMindState.FindId(state);
+		if (slot < 0) {
+			if (delta <= 0)
+				return;
+
+			EnsureNames();
+			string name = "unknown";
+			s_MindStates.Find(state, name);
+			slot = s_MetricMindState.SlotId(state, name);
+		}
+
+		s_MetricMindState.Set(slot, Math.Max(s_MetricMindState.Get(slot) + delta, 0));
 	}
 
 	/**
@@ -78,22 +85,16 @@ class MetricZ_ZombieStats
 		if (type == string.Empty || delta == 0)
 			return;
 
-		int v;
-		if (s_TypeStorage.Find(type, v)) {
-			v = v + delta;
-			if (v <= 0) {
-				s_TypeStorage.Remove(type);
-				s_TypeLabels.Remove(type);
-			} else
-				s_TypeStorage.Set(type, v);
-		} else if (delta > 0) {
-			s_TypeStorage.Insert(type, delta);
-
-			// build labels once per type
-			map<string, string> labels = new map<string, string>();
-			labels.Insert("type", type);
-			s_TypeLabels.Insert(type, MetricZ_LabelUtils.MakeLabels(labels));
+		int slot = s_MetricCountByType.Find(type);
+		if (slot < 0) {
+			if (delta < 0)
+				return;
+
+			slot = s_MetricCountByType.Slot(type);
 		}
+
+		if (s_MetricCountByType.Add(slot, delta) <= 0)
+			s_MetricCountByType.Remove(slot);
 	}
 
 	/**
@@ -160,50 +161,8 @@ class MetricZ_ZombieStats
 		if (!sink)
 			return;
 
-		bool hasStates = (s_CountByType.Count() > 0);
-		bool hasTypes = (s_TypeStorage.Count() > 0);
-
-		if (!hasStates && !hasTypes)
-			return;
-
-		// mind states
-		if (hasStates) {
-			EnsureNames();
-			s_MetricMindState.WriteHeaders(sink);
-
-			foreach (int id, int val : s_CountByType) {
-				s_MetricMindState.Set(val);
-
-				string name = "unknown";
-				s_MindStates.Find(id, name);
-
-				map<string, string> mindLabels = new map<string, string>();
-				mindLabels.Insert("state_id", id.ToString());
-				mindLabels.Insert("state", name);
-
-				s_MetricMindState.Flush(sink, MetricZ_LabelUtils.MakeLabels(mindLabels));
-			}
-		}
-
-		// zombie types
-		if (hasTypes) {
-			s_MetricCountByType.WriteHeaders(sink);
-
-			foreach (string type, int count : s_TypeStorage) {
-				s_MetricCountByType.Set(count);
-
-				string typeLabels = s_TypeLabels.Get(type);
-				if (typeLabels == string.Empty) {
-					// safety: rebuild labels if cache is empty
-					map<string, string> tmp = new map<string, string>();
-					tmp.Insert("type", type);
-					typeLabels = MetricZ_LabelUtils.MakeLabels(tmp);
-					s_TypeLabels.Set(type, typeLabels);
-				}
-
-				s_MetricCountByType.Flush(sink, typeLabels);
-			}
-		}
+		s_MetricMindState.FlushWithHead(sink);
+		s_MetricCountByType.FlushWithHead(sink);
 	}
 }
 #endif
@@ -11,6 +11,8 @@
 */
 class MetricZ_EffectAreaMetrics : MetricZ_EntityMetricsBase
 {
+	protected static ref MetricZ_LabelSchema s_LabelSchema = new MetricZ_LabelSchema("type,class,longitude,latitude,radius"); //!< Area labels.
+
 	protected EffectArea m_Area; //!< Parent EffectArea instance.
 	ref MetricZ_MetricFloat m_Radius; //!< Metric: Radius of the area.
 	ref MetricZ_MetricInt m_Insiders; //!< Metric: Count of players inside the area.
@@ -20,7 +22,7 @@ class MetricZ_EffectAreaMetrics : MetricZ_EntityMetricsBase
 	*/
 	void MetricZ_EffectAreaMetrics()
 	{
-		m_Insiders = new MetricZ_MetricInt(
+		m_Insiders = NewInt(
 		    "effect_area_insiders",
 		    "Count of players inside Effect Area",
 		    MetricZ_MetricType.GAUGE);
@@ -68,16 +70,22 @@ class MetricZ_EffectAreaMetrics : MetricZ_EntityMetricsBase
 		float lon, lat;
 		MetricZ_Geo.GetLonLat(pos, lon, lat);
 
-		map<string, string> labels = new map<string, string>();
-		labels.Insert("type", m_Area.MetricZ_GetType());
-		labels.Insert("class", m_Area.ClassName());
-		labels.Insert("longitude", lon.ToString());
-		labels.Insert("latitude", lat.ToString());
-		labels.Insert("radius", m_Area.MetricZ_GetRadius().ToString());
-
-		m_Labels = MetricZ_LabelUtils.MakeLabels(labels);
+		m_Labels = s_LabelSchema.Render(
+		    m_Area.MetricZ_GetType(),
+		    m_Area.ClassName(),
+		    lon.ToString(),
+		    lat.ToString(),
+		    m_Area.MetricZ_GetRadius().ToString());
 
 		ApplyLabelsToRegistry();
 	}
+
+	/**
+	    \brief Column store for this entity kind, if enabled.
+	*/
+	override protected MetricZ_EntityColumns GetColumns()
+	{
+		return MetricZ_EntityColumns.Areas();
+	}
 }
 #endif
@@ -0,0 +1,96 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Resumable position of an entity family flush.
+    \details Holds the snapshot of entity metrics taken at the start of a scrape cycle
+             and the update/render position, so the flush can yield between server frames.
+*/
+class MetricZ_EntitiesCursor
+{
+	static const int STAGE_COLLECT = 0; //!< Snapshot of entities is not taken yet
+	static const int STAGE_UPDATE = 1; //!< Updating metric values from entity state
+	static const int STAGE_RENDER = 2; //!< Writing interleaved metric families into sink
+	static const int STAGE_DONE = 3; //!< Everything written for this cycle
+
+	int m_Stage; //!< Current stage
+	int m_Entity; //!< Next entity index in the snapshot
+	int m_Metric; //!< Current metric index in render stage
+	int m_MetricsCount; //!< Number of metric families in render stage
+	ref array<ref MetricZ_EntityMetricsBase> m_Items = new array<ref MetricZ_EntityMetricsBase>(); //!< Snapshot
+	MetricZ_EntityColumns m_Columns; //!< Column store of the family, null for per-entity layout
+
+	/**
+	    \brief Drop snapshot and rewind to the collect stage.
+	*/
+	void Reset()
+	{
+		m_Items.Clear();
+		m_Columns = null;
+		m_Stage = STAGE_COLLECT;
+		m_Entity = 0;
+		m_Metric = 0;
+		m_MetricsCount = 0;
+	}
+
+	/**
+	    \brief Switch the snapshot to column store rendering.
+	    \param columns Column store of the family, null keeps per-entity layout
+	*/
+	void UseColumns(MetricZ_EntityColumns columns)
+	{
+		m_Columns = columns;
+		if (m_Columns)
+			m_Columns.BeginCycle();
+	}
+
+	/**
+	    \brief Add entity metrics to the snapshot.
+	    \details Entities with an empty registry are skipped,
+	             so the metric count of every item stays stable until the cycle ends.
+	             With a column store, the entity slot is bound and marked active instead;
+	             an entity that can not be stored in the columns is reported once and left out,
+	             because its samples can not be merged into the column families.
+	    \param metrics Entity metrics instance
+	*/
+	void Insert(MetricZ_EntityMetricsBase metrics)
+	{
+		if (!metrics || metrics.Count() == 0)
+			return;
+
+		if (m_Columns) {
+			MetricZ_EntityColumns columns = metrics.SeekColumns();
+			if (columns != m_Columns) {
+				if (!columns)
+					m_Columns.Warn("entity with own metrics");
+
+				return;
+			}
+
+			m_Columns.SetActive(metrics.GetColumnSlot());
+		}
+
+		m_Items.Insert(metrics);
+	}
+
+	/**
+	    \brief Number of entities in the snapshot.
+	*/
+	int Count()
+	{
+		return m_Items.Count();
+	}
+
+	/**
+	    \brief Check if the cursor has finished the cycle.
+	*/
+	bool IsDone()
+	{
+		return (m_Stage == STAGE_DONE);
+	}
+}
+#endif
@@ -7,15 +7,15 @@
 #ifdef SERVER
 /**
     \brief Helpers for ordered entity metrics output.
+    \details Every family is written in two resumable stages driven by MetricZ_EntitiesCursor:
+             update all entities, then for each metric index write HELP/TYPE once and values for all entities.
+             The `*Step` methods yield when the frame deadline is reached and continue on the next call.
 */
 class MetricZ_EntitiesWriter
 {
 	// Static buffers for Object Pooling
 	static ref array<Man> s_PlayersListBuffer = new array<Man>();
-	static ref array<ref MetricZ_PlayerMetrics> s_PlayerMetricsBuffer = new array<ref MetricZ_PlayerMetrics>();
-	static ref array<ref MetricZ_TransportMetrics> s_TransportMetricsBuffer = new array<ref MetricZ_TransportMetrics>();
-	static ref array<ref MetricZ_TerritoryMetrics> s_TerritoryMetricsBuffer = new array<ref MetricZ_TerritoryMetrics>();
-	static ref array<ref MetricZ_EffectAreaMetrics> s_AreaMetricsBuffer = new array<ref MetricZ_EffectAreaMetrics>();
+	static ref MetricZ_EntitiesCursor s_Cursor = new MetricZ_EntitiesCursor(); //!< Cursor for non-resumable flush
 
 	/**
 	    \brief Flush all player metrics in interleaved order.
@@ -24,42 +24,38 @@ class MetricZ_EntitiesWriter
 	*/
 	static void FlushPlayers(MetricZ_SinkBase sink)
 	{
-		if (!sink)
-			return;
-
-		s_PlayerMetricsBuffer.Clear();
-		s_PlayersListBuffer.Clear();
-		g_Game.GetPlayers(s_PlayersListBuffer);
-
-		foreach (Man man : s_PlayersListBuffer) {
-			PlayerBase player;
-			if (!Class.CastTo(player, man))
-				continue;
-
-			MetricZ_PlayerMetrics pm = player.MetricZ_GetMetrics();
-			if (!pm)
-				continue;
-
-			pm.Update();
-			s_PlayerMetricsBuffer.Insert(pm);
-		}
+		s_Cursor.Reset();
+		FlushPlayersStep(sink, s_Cursor, float.MAX);
+	}
 
-		if (s_PlayerMetricsBuffer.Count() == 0)
-			return;
+	/**
+	    \brief Resumable flush of player metrics.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param cursor Cursor reset at the start of the scrape cycle
+	    \param deadline Tick time (seconds) after which the step yields
+	    \return \p bool True when all player metrics are written
+	*/
+	static bool FlushPlayersStep(MetricZ_SinkBase sink, MetricZ_EntitiesCursor cursor, float deadline)
+	{
+		if (!sink || !cursor)
+			return true;
 
-		int metricsCount = s_PlayerMetricsBuffer[0].Count();
-		for (int i = 0; i < metricsCount; ++i) {
-			s_PlayerMetricsBuffer[0].WriteHeaderAt(sink, i);
+		if (cursor.m_Stage == MetricZ_EntitiesCursor.STAGE_COLLECT) {
+			cursor.UseColumns(MetricZ_EntityColumns.Players());
 
-			foreach (MetricZ_PlayerMetrics pmCurrent : s_PlayerMetricsBuffer) {
-				if (i >= pmCurrent.Count())
-					continue;
+			s_PlayersListBuffer.Clear();
+			g_Game.GetPlayers(s_PlayersListBuffer);
 
-				MetricZ_MetricBase metric = pmCurrent.GetMetricDirect(i);
-				if (metric)
-					metric.Flush(sink);
+			foreach (Man man : s_PlayersListBuffer) {
+				PlayerBase player;
+				if (Class.CastTo(player, man))
+					cursor.Insert(player.MetricZ_GetMetrics());
 			}
+
+			s_PlayersListBuffer.Clear();
 		}
+
+		return FlushStep(sink, cursor, deadline);
 	}
 
 	/**
@@ -69,64 +65,35 @@ class MetricZ_EntitiesWriter
 	*/
 	static void FlushTransport(MetricZ_SinkBase sink)
 	{
-		if (!sink)
-			return;
+		s_Cursor.Reset();
+		FlushTransportStep(sink, s_Cursor, float.MAX);
+	}
 
-		array<Transport> list = MetricZ_TransportRegistry.GetList();
-		if (!list || list.Count() == 0)
-			return;
+	/**
+	    \brief Resumable flush of transport metrics.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param cursor Cursor reset at the start of the scrape cycle
+	    \param deadline Tick time (seconds) after which the step yields
+	    \return \p bool True when all transport metrics are written
+	*/
+	static bool FlushTransportStep(MetricZ_SinkBase sink, MetricZ_EntitiesCursor cursor, float deadline)
+	{
+		if (!sink || !cursor)
+			return true;
 
-		s_TransportMetricsBuffer.Clear();
-		foreach (Transport transport : list) {
-			if (!transport)
-				continue;
-
-			MetricZ_TransportMetrics tm;
-
-			CarScript car = CarScript.Cast(transport);
-			if (car)
-				tm = car.MetricZ_GetMetrics();
-			else {
-				BoatScript boat = BoatScript.Cast(transport);
-				if (boat)
-					tm = boat.MetricZ_GetMetrics();
-				else {
-					HelicopterScript heli = HelicopterScript.Cast(transport);
-					if (heli)
-						tm = heli.MetricZ_GetMetrics();
-#ifdef EXPANSIONMODVEHICLE
-					else {
-						ExpansionVehicleBase expansionVeh = ExpansionVehicleBase.Cast(transport);
-						if (expansionVeh)
-							tm = expansionVeh.MetricZ_GetMetrics();
-					}
-#endif
+		if (cursor.m_Stage == MetricZ_EntitiesCursor.STAGE_COLLECT) {
+			cursor.UseColumns(MetricZ_EntityColumns.Transports());
+
+			array<Transport> list = MetricZ_TransportRegistry.GetList();
+			if (list) {
+				foreach (Transport transport : list) {
+					if (transport)
+						cursor.Insert(GetTransportMetrics(transport));
 				}
 			}
-
-			if (!tm)
-				continue;
-
-			tm.Update();
-			s_TransportMetricsBuffer.Insert(tm);
 		}
 
-		if (s_TransportMetricsBuffer.Count() == 0)
-			return;
-
-		int metricsCount = s_TransportMetricsBuffer[0].Count();
-		for (int i = 0; i < metricsCount; ++i) {
-			s_TransportMetricsBuffer[0].WriteHeaderAt(sink, i);
-
-			foreach (MetricZ_TransportMetrics tmCurrent : s_TransportMetricsBuffer) {
-				if (i >= tmCurrent.Count())
-					continue;
-
-				MetricZ_MetricBase metric = tmCurrent.GetMetricDirect(i);
-				if (metric)
-					metric.Flush(sink);
-			}
-		}
+		return FlushStep(sink, cursor, deadline);
 	}
 
 	/**
@@ -136,42 +103,35 @@ class MetricZ_EntitiesWriter
 	*/
 	static void FlushTerritory(MetricZ_SinkBase sink)
 	{
-		if (!sink)
-			return;
-
-		array<TerritoryFlag> list = MetricZ_TerritoryRegistry.GetList();
-		if (!list || list.Count() == 0)
-			return;
-
-		s_TerritoryMetricsBuffer.Clear();
-		foreach (TerritoryFlag territory : list) {
-			if (!territory)
-				continue;
-
-			MetricZ_TerritoryMetrics fm = territory.MetricZ_GetMetrics();
-			if (!fm)
-				continue;
-
-			fm.Update();
-			s_TerritoryMetricsBuffer.Insert(fm);
-		}
-
-		if (s_TerritoryMetricsBuffer.Count() == 0)
-			return;
+		s_Cursor.Reset();
+		FlushTerritoryStep(sink, s_Cursor, float.MAX);
+	}
 
-		int n = s_TerritoryMetricsBuffer[0].Count();
-		for (int i = 0; i < n; ++i) {
-			s_TerritoryMetricsBuffer[0].WriteHeaderAt(sink, i);
+	/**
+	    \brief Resumable flush of territory metrics.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param cursor Cursor reset at the start of the scrape cycle
+	    \param deadline Tick time (seconds) after which the step yields
+	    \return \p bool True when all territory metrics are written
+	*/
+	static bool FlushTerritoryStep(MetricZ_SinkBase sink, MetricZ_EntitiesCursor cursor, float deadline)
+	{
+		if (!sink || !cursor)
+			return true;
 
-			foreach (MetricZ_TerritoryMetrics fmCurrent : s_TerritoryMetricsBuffer) {
-				if (i >= fmCurrent.Count())
-					continue;
+		if (cursor.m_Stage == MetricZ_EntitiesCursor.STAGE_COLLECT) {
+			cursor.UseColumns(MetricZ_EntityColumns.Territories());
 
-				MetricZ_MetricBase metric = fmCurrent.GetMetricDirect(i);
-				if (metric)
-					metric.Flush(sink);
+			array<TerritoryFlag> list = MetricZ_TerritoryRegistry.GetList();
+			if (list) {
+				foreach (TerritoryFlag territory : list) {
+					if (territory)
+						cursor.Insert(territory.MetricZ_GetMetrics());
+				}
 			}
 		}
+
+		return FlushStep(sink, cursor, deadline);
 	}
 
 	/**
@@ -193,42 +153,194 @@ class MetricZ_EntitiesWriter
 	*/
 	static void FlushEffectAreas(MetricZ_SinkBase sink)
 	{
-		if (!sink)
-			return;
+		s_Cursor.Reset();
+		FlushEffectAreasStep(sink, s_Cursor, float.MAX);
+	}
 
-		array<EffectArea> list = MetricZ_EffectAreaRegistry.GetList();
-		if (!list || list.Count() == 0)
-			return;
+	/**
+	    \brief Resumable flush of EffectArea metrics.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param cursor Cursor reset at the start of the scrape cycle
+	    \param deadline Tick time (seconds) after which the step yields
+	    \return \p bool True when all EffectArea metrics are written
+	*/
+	static bool FlushEffectAreasStep(MetricZ_SinkBase sink, MetricZ_EntitiesCursor cursor, float deadline)
+	{
+		if (!sink || !cursor)
+			return true;
+
+		if (cursor.m_Stage == MetricZ_EntitiesCursor.STAGE_COLLECT) {
+			cursor.UseColumns(MetricZ_EntityColumns.Areas());
+
+			array<EffectArea> list = MetricZ_EffectAreaRegistry.GetList();
+			if (list) {
+				foreach (EffectArea area : list) {
+					if (area)
+						cursor.Insert(area.MetricZ_GetMetrics());
+				}
+			}
+		}
+
+		return FlushStep(sink, cursor, deadline);
+	}
+
+	/**
+	    \brief Resolve metrics instance of a transport by its script class.
+	    \param transport Transport instance
+	    \return \p MetricZ_TransportMetrics or null
+	*/
+	protected static MetricZ_TransportMetrics GetTransportMetrics(Transport transport)
+	{
+		CarScript car = CarScript.Cast(transport);
+		if (car)
+			return car.MetricZ_GetMetrics();
+
+		BoatScript boat = BoatScript.Cast(transport);
+		if (boat)
+			return boat.MetricZ_GetMetrics();
 
-		s_AreaMetricsBuffer.Clear();
-		foreach (EffectArea area : list) {
-			if (!area)
-				continue;
+		HelicopterScript heli = HelicopterScript.Cast(transport);
+		if (heli)
+			return heli.MetricZ_GetMetrics();
+
+#ifdef EXPANSIONMODVEHICLE
+		ExpansionVehicleBase expansionVeh = ExpansionVehicleBase.Cast(transport);
+		if (expansionVeh)
+			return expansionVeh.MetricZ_GetMetrics();
+#endif
+
+		return null;
+	}
 
-			MetricZ_EffectAreaMetrics am = area.MetricZ_GetMetrics();
-			if (!am)
-				continue;
+	/**
+	    \brief Run update and render stages of a collected snapshot until done or deadline.
+	    \details Deadline is checked every MetricZ_Constants.FLUSH_YIELD_STRIDE entities,
+	             at least one stride of work is done per call.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param cursor Cursor with snapshot
+	    \param deadline Tick time (seconds) after which the step yields
+	    \return \p bool True when the family is completely written
+	*/
+	protected static bool FlushStep(MetricZ_SinkBase sink, MetricZ_EntitiesCursor cursor, float deadline)
+	{
+		int count = cursor.Count();
+		int work = 0;
 
-			am.Update();
-			s_AreaMetricsBuffer.Insert(am);
+		if (cursor.m_Stage == MetricZ_EntitiesCursor.STAGE_COLLECT) {
+			cursor.m_Entity = 0;
+			cursor.m_Stage = MetricZ_EntitiesCursor.STAGE_UPDATE;
 		}
 
-		if (s_AreaMetricsBuffer.Count() == 0)
-			return;
+		// update values of all entities first, so every family renders the same moment
+		if (cursor.m_Stage == MetricZ_EntitiesCursor.STAGE_UPDATE) {
+			while (cursor.m_Entity < count) {
+				MetricZ_EntityMetricsBase updated = cursor.m_Items[cursor.m_Entity];
+				if (cursor.m_Columns)
+					updated.SeekColumns();
+
+				updated.Update();
+				cursor.m_Entity++;
+
+				work++;
+				if (work >= MetricZ_Constants.FLUSH_YIELD_STRIDE) {
+					work = 0;
+					if (g_Game.GetTickTime() >= deadline)
+						return false;
+				}
+			}
 
-		int n = s_AreaMetricsBuffer[0].Count();
-		for (int i = 0; i < n; ++i) {
-			s_AreaMetricsBuffer[0].WriteHeaderAt(sink, i);
+			cursor.m_Entity = 0;
+			cursor.m_Metric = 0;
+			cursor.m_MetricsCount = 0;
+			if (count > 0)
+				cursor.m_MetricsCount = cursor.m_Items[0].Count();
 
-			foreach (MetricZ_EffectAreaMetrics amCurrent : s_AreaMetricsBuffer) {
-				if (i >= amCurrent.Count())
-					continue;
+			cursor.m_Stage = MetricZ_EntitiesCursor.STAGE_RENDER;
+		}
+
+		if (cursor.m_Columns && cursor.m_Stage == MetricZ_EntitiesCursor.STAGE_RENDER)
+			return FlushColumnsStep(sink, cursor, deadline);
+
+		// interleaved output, header written once when entering a family
+		if (cursor.m_Stage == MetricZ_EntitiesCursor.STAGE_RENDER) {
+			while (cursor.m_Metric < cursor.m_MetricsCount) {
+				int i = cursor.m_Metric;
+
+				if (cursor.m_Entity == 0)
+					cursor.m_Items[0].WriteHeaderAt(sink, i);
+
+				while (cursor.m_Entity < count) {
+					MetricZ_EntityMetricsBase item = cursor.m_Items[cursor.m_Entity];
+					cursor.m_Entity++;
+
+					if (i < item.Count()) {
+						MetricZ_MetricBase metric = item.GetMetricDirect(i);
+						if (metric)
+							metric.Flush(sink);
+					}
+
+					work++;
+					if (work >= MetricZ_Constants.FLUSH_YIELD_STRIDE) {
+						work = 0;
+						if (g_Game.GetTickTime() >= deadline && cursor.m_Entity < count)
+							return false;
+					}
+				}
+
+				cursor.m_Entity = 0;
+				cursor.m_Metric++;
+			}
+
+			// release snapshot references until next cycle
+			cursor.m_Items.Clear();
+			cursor.m_Stage = MetricZ_EntitiesCursor.STAGE_DONE;
+		}
 
-				MetricZ_MetricBase metric = amCurrent.GetMetricDirect(i);
-				if (metric)
-					metric.Flush(sink);
+		return true;
+	}
+
+	/**
+	    \brief Render stage for column store layout.
+	    \details For each family: header once, then one loop over the slot arrays of the store.
+	             Slots not in the current snapshot are skipped.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param cursor Cursor in render stage with column store
+	    \param deadline Tick time (seconds) after which the step yields
+	    \return \p bool True when the family is completely written
+	*/
+	protected static bool FlushColumnsStep(MetricZ_SinkBase sink, MetricZ_EntitiesCursor cursor, float deadline)
+	{
+		MetricZ_EntityColumns columns = cursor.m_Columns;
+		int slots = columns.SlotsCount();
+		int work = 0;
+
+		while (cursor.m_Metric < cursor.m_MetricsCount) {
+			int i = cursor.m_Metric;
+
+			if (cursor.m_Entity == 0)
+				columns.WriteHeaderAt(sink, i);
+
+			while (cursor.m_Entity < slots) {
+				columns.FlushAt(sink, i, cursor.m_Entity);
+				cursor.m_Entity++;
+
+				work++;
+				if (work >= MetricZ_Constants.FLUSH_YIELD_STRIDE) {
+					work = 0;
+					if (g_Game.GetTickTime() >= deadline && cursor.m_Entity < slots)
+						return false;
+				}
 			}
+
+			cursor.m_Entity = 0;
+			cursor.m_Metric++;
 		}
+
+		// release snapshot references until next cycle
+		cursor.m_Items.Clear();
+		cursor.m_Stage = MetricZ_EntitiesCursor.STAGE_DONE;
+
+		return true;
 	}
 }
 #endif
@@ -0,0 +1,276 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    Copyright (c) 2025 WoozyMasta
+    Source: https://github.com/woozymasta/metricz
+*/
+
+#ifdef SERVER
+/**
+    \brief Column store of one entity kind (struct-of-arrays layout).
+    \details Every metric family owns a MetricZ_MetricColumn with values, label blocks and rendered
+             lines indexed by entity slot, and one metric handle shared by all entities of the kind.
+             Entity metrics bind their registry of handles to a slot once and Seek() it before
+             writing, slots of destroyed entities go to a free list and are reused.
+             Enabled per collector by `column_store` config options.
+*/
+class MetricZ_EntityColumns
+{
+	protected static ref MetricZ_EntityColumns s_Players;
+	protected static ref MetricZ_EntityColumns s_Transports;
+	protected static ref MetricZ_EntityColumns s_Territories;
+	protected static ref MetricZ_EntityColumns s_Areas;
+
+	protected ref array<ref MetricZ_MetricColumn> m_Columns = new array<ref MetricZ_MetricColumn>(); //!< Column by registry index
+	protected ref array<bool> m_Used = new array<bool>(); //!< Slot is owned by an entity
+	protected ref array<bool> m_Active = new array<bool>(); //!< Slot is in the current scrape snapshot
+	protected ref array<int> m_Free = new array<int>(); //!< Released slots for reuse
+	protected ref map<string, ref MetricZ_MetricBase> m_Handles = new map<string, ref MetricZ_MetricBase>(); //!< Shared handle by family name
+	protected bool m_Warned; //!< Layout mismatch was reported
+
+	/**
+	    \brief Store for player metrics, null if disabled in config.
+	*/
+	static MetricZ_EntityColumns Players()
+	{
+		if (!MetricZ_Config.IsLoaded() || !MetricZ_Config.Get().column_store.players)
+			return null;
+
+		if (!s_Players)
+			s_Players = new MetricZ_EntityColumns();
+
+		return s_Players;
+	}
+
+	/**
+	    \brief Store for transport metrics, null if disabled in config.
+	*/
+	static MetricZ_EntityColumns Transports()
+	{
+		if (!MetricZ_Config.IsLoaded() || !MetricZ_Config.Get().column_store.transports)
+			return null;
+
+		if (!s_Transports)
+			s_Transports = new MetricZ_EntityColumns();
+
+		return s_Transports;
+	}
+
+	/**
+	    \brief Store for territory flag metrics, null if disabled in config.
+	*/
+	static MetricZ_EntityColumns Territories()
+	{
+		if (!MetricZ_Config.IsLoaded() || !MetricZ_Config.Get().column_store.territories)
+			return null;
+
+		if (!s_Territories)
+			s_Territories = new MetricZ_EntityColumns();
+
+		return s_Territories;
+	}
+
+	/**
+	    \brief Store for EffectArea metrics, null if disabled in config.
+	*/
+	static MetricZ_EntityColumns Areas()
+	{
+		if (!MetricZ_Config.IsLoaded() || !MetricZ_Config.Get().column_store.areas)
+			return null;
+
+		if (!s_Areas)
+			s_Areas = new MetricZ_EntityColumns();
+
+		return s_Areas;
+	}
+
+	/**
+	    \brief Get the shared integer handle of a family, created on first call.
+	    \param name Metric name
+	    \param help HELP text
+	    \param type Metric type (GAUGE/COUNTER)
+	    \return \p MetricZ_MetricInt
+	*/
+	MetricZ_MetricInt IntHandle(string name, string help, MetricZ_MetricType type)
+	{
+		MetricZ_MetricBase handle;
+		if (!m_Handles.Find(name, handle)) {
+			handle = new MetricZ_MetricInt(name, help, type);
+			m_Handles.Insert(name, handle);
+		}
+
+		return MetricZ_MetricInt.Cast(handle);
+	}
+
+	/**
+	    \brief Get the shared float handle of a family, created on first call.
+	    \param name Metric name
+	    \param help HELP text
+	    \param type Metric type (GAUGE/COUNTER)
+	    \return \p MetricZ_MetricFloat
+	*/
+	MetricZ_MetricFloat FloatHandle(string name, string help, MetricZ_MetricType type)
+	{
+		MetricZ_MetricBase handle;
+		if (!m_Handles.Find(name, handle)) {
+			handle = new MetricZ_MetricFloat(name, help, type);
+			m_Handles.Insert(name, handle);
+		}
+
+		return MetricZ_MetricFloat.Cast(handle);
+	}
+
+	/**
+	    \brief Allocate a slot for a registry of shared handles.
+	    \details Columns are defined from the first registry bound to the store and the handles
+	             are attached to them. Registries with a different layout are rejected.
+	    \param registry Entity metrics registry
+	    \return \p int Slot index or -1 on layout mismatch
+	*/
+	int Bind(array<ref MetricZ_MetricBase> registry)
+	{
+		if (!registry || registry.Count() == 0)
+			return -1;
+
+		if (m_Columns.Count() == 0) {
+			foreach (MetricZ_MetricBase metric : registry) {
+				bool isInt = (MetricZ_MetricInt.Cast(metric) != null);
+				MetricZ_MetricColumn added = new MetricZ_MetricColumn(metric.GetDescriptor(), isInt);
+				m_Columns.Insert(added);
+				metric.BindColumn(added);
+			}
+		}
+
+		int count = m_Columns.Count();
+		if (registry.Count() != count) {
+			Warn("layout mismatch " + registry.Count() + " != " + count);
+			return -1;
+		}
+
+		for (int i = 0; i < count; i++) {
+			if (registry[i].GetDescriptor() != m_Columns[i].GetDescriptor()) {
+				Warn("family mismatch " + registry[i].GetName());
+				return -1;
+			}
+		}
+
+		int slot;
+		if (m_Free.Count() > 0) {
+			slot = m_Free[m_Free.Count() - 1];
+			m_Free.Remove(m_Free.Count() - 1);
+		} else {
+			slot = m_Used.Count();
+			m_Used.Insert(false);
+			m_Active.Insert(false);
+
+			foreach (MetricZ_MetricColumn column : m_Columns)
+				column.Resize(slot + 1);
+		}
+
+		m_Used[slot] = true;
+		m_Active[slot] = false;
+
+		foreach (MetricZ_MetricColumn cleared : m_Columns)
+			cleared.Clear(slot);
+
+		return slot;
+	}
+
+	/**
+	    \brief Point the shared handles at a slot.
+	    \param slot Slot index, -1 drops writes through the handles
+	*/
+	void Seek(int slot)
+	{
+		foreach (MetricZ_MetricColumn column : m_Columns)
+			column.Seek(slot);
+	}
+
+	/**
+	    \brief Report an entity that can not be stored in the columns, once per store.
+	    \details Such an entity is left out of the column snapshot, its samples are not written.
+	    \param reason Mismatch description
+	*/
+	void Warn(string reason)
+	{
+		if (m_Warned)
+			return;
+
+		m_Warned = true;
+		ErrorEx("MetricZ: column store " + reason + ", entity is not exported (reported once)", ErrorExSeverity.WARNING);
+	}
+
+	/**
+	    \brief Return slot to the free list.
+	    \param slot Slot index
+	*/
+	void Release(int slot)
+	{
+		if (slot < 0 || slot >= m_Used.Count() || !m_Used[slot])
+			return;
+
+		m_Used[slot] = false;
+		m_Active[slot] = false;
+		m_Free.Insert(slot);
+
+		Seek(-1);
+	}
+
+	/**
+	    \brief Clear snapshot flags at the start of a scrape cycle.
+	*/
+	void BeginCycle()
+	{
+		int slots = m_Active.Count();
+		for (int i = 0; i < slots; i++)
+			m_Active[i] = false;
+	}
+
+	/**
+	    \brief Include slot into the current scrape snapshot.
+	    \param slot Slot index
+	*/
+	void SetActive(int slot)
+	{
+		if (slot >= 0 && slot < m_Active.Count())
+			m_Active[slot] = true;
+	}
+
+	/**
+	    \brief Number of metric families.
+	*/
+	int FamiliesCount()
+	{
+		return m_Columns.Count();
+	}
+
+	/**
+	    \brief Number of allocated slots, including free ones.
+	*/
+	int SlotsCount()
+	{
+		return m_Active.Count();
+	}
+
+	/**
+	    \brief Write HELP/TYPE of a family.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param family Family index
+	*/
+	void WriteHeaderAt(MetricZ_SinkBase sink, int family)
+	{
+		m_Columns[family].WriteHeaders(sink);
+	}
+
+	/**
+	    \brief Write sample line of a family for a slot if it is in the current snapshot.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param family Family index
+	    \param slot Slot index
+	*/
+	void FlushAt(MetricZ_SinkBase sink, int family, int slot)
+	{
+		if (m_Active[slot])
+			m_Columns[family].FlushAt(sink, slot);
+	}
+}
+#endif
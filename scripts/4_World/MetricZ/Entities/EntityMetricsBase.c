@@ -13,6 +13,14 @@ class MetricZ_EntityMetricsBase
 {
 	protected string m_Labels;
 	protected ref array<ref MetricZ_MetricBase> m_Registry = new array<ref MetricZ_MetricBase>();
+	protected MetricZ_EntityColumns m_Columns; //!< Column store owning the shared handles of the registry, null for own metrics
+	protected int m_ColumnSlot = -1; //!< Slot in m_Columns
+
+	void ~MetricZ_EntityMetricsBase()
+	{
+		if (m_Columns && m_ColumnSlot >= 0)
+			m_Columns.Release(m_ColumnSlot);
+	}
 
 	/**
 	    \brief Return number of registered metrics.
@@ -28,6 +36,35 @@ class MetricZ_EntityMetricsBase
 	*/
 	void Update() {} // redefined in children
 
+	/**
+	    \brief Bind registry to its column store slot on first call and point the shared handles at it.
+	    \details Must be called before values or labels are written through shared handles.
+	    \return \p MetricZ_EntityColumns Store with the selected slot, or null if column layout is not used
+	*/
+	MetricZ_EntityColumns SeekColumns()
+	{
+		if (!m_Columns)
+			return null;
+
+		if (m_ColumnSlot < 0)
+			m_ColumnSlot = m_Columns.Bind(m_Registry);
+
+		m_Columns.Seek(m_ColumnSlot);
+		if (m_ColumnSlot < 0)
+			return null;
+
+		return m_Columns;
+	}
+
+	/**
+	    \brief Get slot index in the column store.
+	    \return \p int Slot or -1 if not bound
+	*/
+	int GetColumnSlot()
+	{
+		return m_ColumnSlot;
+	}
+
 	/**
 	    \brief Get metric object directly by index (Unsafe/Fast).
 	*/
@@ -116,10 +153,58 @@ class MetricZ_EntityMetricsBase
 		if (m_Registry.Count() == 0)
 			return;
 
+		if (m_Columns && !SeekColumns())
+			return;
+
 		foreach (MetricZ_MetricBase metric : m_Registry)
 			metric.SetLabels(m_Labels);
 	}
 
+	/**
+	    \brief Column store for this entity kind.
+	    \details Defaults to none (per-entity layout). Override in descendants as needed.
+	*/
+	protected MetricZ_EntityColumns GetColumns()
+	{
+		return null;
+	}
+
+	/**
+	    \brief Create an integer metric, or take the shared handle of the column store if enabled.
+	    \param name Metric name
+	    \param help HELP text
+	    \param type Metric type (GAUGE/COUNTER)
+	    \return \p MetricZ_MetricInt
+	*/
+	protected MetricZ_MetricInt NewInt(string name, string help, MetricZ_MetricType type)
+	{
+		MetricZ_EntityColumns columns = GetColumns();
+		if (!columns)
+			return new MetricZ_MetricInt(name, help, type);
+
+		m_Columns = columns;
+
+		return columns.IntHandle(name, help, type);
+	}
+
+	/**
+	    \brief Create a float metric, or take the shared handle of the column store if enabled.
+	    \param name Metric name
+	    \param help HELP text
+	    \param type Metric type (GAUGE/COUNTER)
+	    \return \p MetricZ_MetricFloat
+	*/
+	protected MetricZ_MetricFloat NewFloat(string name, string help, MetricZ_MetricType type)
+	{
+		MetricZ_EntityColumns columns = GetColumns();
+		if (!columns)
+			return new MetricZ_MetricFloat(name, help, type);
+
+		m_Columns = columns;
+
+		return columns.FloatHandle(name, help, type);
+	}
+
 	/**
 	    \brief Select a set of labels for a specific metric.
 	    \param metric MetricZ_MetricBase instance.
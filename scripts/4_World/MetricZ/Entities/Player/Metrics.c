@@ -20,6 +20,10 @@ class MetricZ_PlayerMetrics : MetricZ_EntityMetricsBase
 	protected int m_ThrottleWindow = -1; //!< Throttle window.
 	protected float m_SampleAccTime; //!< Sample accumulation time.
 
+	// Label schemas: common and extra labels for the player.
+	protected static ref MetricZ_LabelSchema s_LabelSchema = new MetricZ_LabelSchema("steam_id");
+	protected static ref MetricZ_LabelSchema s_LabelSchemaExtra = new MetricZ_LabelSchema("steam_id,guid,name,blood,gender,type");
+
 	// Extra labels for the player.
 	protected string m_LabelsExtra;
 
@@ -73,133 +77,133 @@ class MetricZ_PlayerMetrics : MetricZ_EntityMetricsBase
 		m_InitTick = g_Game.GetTickTime(); // seconds
 
 		// vitals
-		m_IsLoaded = new MetricZ_MetricInt(
+		m_IsLoaded = NewInt(
 		    "player_loaded",
 		    "Is player loaded (extra labels holder)",
 		    MetricZ_MetricType.GAUGE);
-		m_Health = new MetricZ_MetricFloat(
+		m_Health = NewFloat(
 		    "player_health",
 		    "Player health 0..1",
 		    MetricZ_MetricType.GAUGE);
-		m_Blood = new MetricZ_MetricFloat(
+		m_Blood = NewFloat(
 		    "player_blood",
 		    "Player blood 0..1",
 		    MetricZ_MetricType.GAUGE);
-		m_Shock = new MetricZ_MetricFloat(
+		m_Shock = NewFloat(
 		    "player_shock",
 		    "Player shock 0..1",
 		    MetricZ_MetricType.GAUGE);
-		m_Energy = new MetricZ_MetricFloat(
+		m_Energy = NewFloat(
 		    "player_energy",
 		    "Player energy 0..1",
 		    MetricZ_MetricType.GAUGE);
-		m_Water = new MetricZ_MetricFloat(
+		m_Water = NewFloat(
 		    "player_water",
 		    "Player hydration 0..1",
 		    MetricZ_MetricType.GAUGE);
-		m_Toxicity = new MetricZ_MetricFloat(
+		m_Toxicity = NewFloat(
 		    "player_toxicity",
 		    "Player toxicity 0..1",
 		    MetricZ_MetricType.GAUGE);
-		m_TempC = new MetricZ_MetricFloat(
+		m_TempC = NewFloat(
 		    "player_temperature_celsius",
 		    "Player body temperature in celsius",
 		    MetricZ_MetricType.GAUGE);
-		m_Weight = new MetricZ_MetricFloat(
+		m_Weight = NewFloat(
 		    "player_weight",
 		    "Player total weight in grams",
 		    MetricZ_MetricType.GAUGE);
-		m_Wetness = new MetricZ_MetricFloat(
+		m_Wetness = NewFloat(
 		    "player_wetness",
 		    "Player wetness 0..1",
 		    MetricZ_MetricType.GAUGE);
-		m_LifeSeconds = new MetricZ_MetricFloat(
+		m_LifeSeconds = NewFloat(
 		    "player_lifetime_seconds",
 		    "Player lifetime since spawn or load in seconds",
 		    MetricZ_MetricType.GAUGE);
 
 		// position
 		if (!MetricZ_Config.Get().disabled_metrics.positions) {
-			m_PosX = new MetricZ_MetricFloat(
+			m_PosX = NewFloat(
 			    "player_position_x",
 			    "Player world X",
 			    MetricZ_MetricType.GAUGE);
-			m_PosZ = new MetricZ_MetricFloat(
+			m_PosZ = NewFloat(
 			    "player_position_z",
 			    "Player world Z",
 			    MetricZ_MetricType.GAUGE);
 
 			if (!MetricZ_Config.Get().disabled_metrics.positions_height)
-				m_PosY = new MetricZ_MetricFloat(
+				m_PosY = NewFloat(
 				    "player_position_y",
 				    "Player world Y",
 				    MetricZ_MetricType.GAUGE);
 
 			if (!MetricZ_Config.Get().disabled_metrics.positions_yaw)
-				m_Yaw = new MetricZ_MetricFloat(
+				m_Yaw = NewFloat(
 				    "player_orientation",
 				    "Player yaw degrees",
 				    MetricZ_MetricType.GAUGE);
 		}
 
 		// identity
-		m_PingMin = new MetricZ_MetricInt(
+		m_PingMin = NewInt(
 		    "player_network_ping_min",
 		    "Player network ping min",
 		    MetricZ_MetricType.GAUGE);
-		m_PingMax = new MetricZ_MetricInt(
+		m_PingMax = NewInt(
 		    "player_network_ping_max",
 		    "Player network ping max",
 		    MetricZ_MetricType.GAUGE);
-		m_Throttle = new MetricZ_MetricFloat(
+		m_Throttle = NewFloat(
 		    "player_network_throttle",
 		    "Fraction of outgoing bandwidth throttled since last update 0..1",
 		    MetricZ_MetricType.GAUGE);
 
 		// extra stats
-		m_AgentsCount = new MetricZ_MetricInt(
+		m_AgentsCount = NewInt(
 		    "player_agents_active",
 		    "Number of active disease agents affecting the player",
 		    MetricZ_MetricType.GAUGE);
-		m_BleedingSources = new MetricZ_MetricInt(
+		m_BleedingSources = NewInt(
 		    "player_bleeding_active",
 		    "Number of active bleeding sources on player",
 		    MetricZ_MetricType.GAUGE);
-		m_ImmunityBoosted = new MetricZ_MetricInt(
+		m_ImmunityBoosted = NewInt(
 		    "player_immunity_boosted",
 		    "Immunity boosted (0/1)",
 		    MetricZ_MetricType.GAUGE);
-		m_Unconscious = new MetricZ_MetricInt(
+		m_Unconscious = NewInt(
 		    "player_unconscious",
 		    "Is unconscious (0/1)",
 		    MetricZ_MetricType.GAUGE);
-		m_Restrained = new MetricZ_MetricInt(
+		m_Restrained = NewInt(
 		    "player_restrained",
 		    "Is restrained (0/1)",
 		    MetricZ_MetricType.GAUGE);
-		m_GodMode = new MetricZ_MetricInt(
+		m_GodMode = NewInt(
 		    "player_godmode",
 		    "Damage disabled (0/1)",
 		    MetricZ_MetricType.GAUGE);
 
 		// analytics
-		m_StatPlaytimeSeconds = new MetricZ_MetricFloat(
+		m_StatPlaytimeSeconds = NewFloat(
 		    "player_stat_playtime_seconds",
 		    "Analytics playtime",
 		    MetricZ_MetricType.GAUGE);
-		m_StatDistanceMeters = new MetricZ_MetricFloat(
+		m_StatDistanceMeters = NewFloat(
 		    "player_stat_distance_meters",
 		    "Analytics distance",
 		    MetricZ_MetricType.GAUGE);
-		m_StatLongestSurvivorHitMeters = new MetricZ_MetricFloat(
+		m_StatLongestSurvivorHitMeters = NewFloat(
 		    "player_stat_longest_survivor_hit_m",
 		    "Analytics longest survivor hit",
 		    MetricZ_MetricType.GAUGE);
-		m_StatPlayersKilledTotal = new MetricZ_MetricInt(
+		m_StatPlayersKilledTotal = NewInt(
 		    "player_stat_players_killed",
 		    "Analytics players killed total",
 		    MetricZ_MetricType.COUNTER);
-		m_StatInfectedKilledTotal = new MetricZ_MetricInt(
+		m_StatInfectedKilledTotal = NewInt(
 		    "player_stat_infected_killed",
 		    "Analytics infected killed total",
 		    MetricZ_MetricType.COUNTER);
@@ -363,10 +367,8 @@ class MetricZ_PlayerMetrics : MetricZ_EntityMetricsBase
 		if (!identity)
 			return;
 
-		map<string, string> labels = new map<string, string>();
-
-		labels.Insert("steam_id", identity.GetPlainId());
-		m_Labels = MetricZ_LabelUtils.MakeLabels(labels);
+		string steamId = identity.GetPlainId();
+		m_Labels = s_LabelSchema.Render(steamId);
 
 		string playerType = m_Player.GetType();
 		playerType.TrimInPlace();
@@ -375,27 +377,17 @@ class MetricZ_PlayerMetrics : MetricZ_EntityMetricsBase
 		string _t;
 		string bloodType = BloodTypes.GetBloodTypeName(m_Player.GetStatBloodType().Get(), _t, _p);
 
-		labels.Insert("guid", identity.GetId());
-
-		string name = identity.GetName();
-		if (name != string.Empty)
-			labels.Insert("name", name);
-
-		if (bloodType != string.Empty)
-			labels.Insert("blood", bloodType);
-
+		string gender;
 		if (m_Player.IsMale()) {
 			playerType.Replace("SurvivorM_", "");
-			labels.Insert("gender", "male");
+			gender = "male";
 		} else {
 			playerType.Replace("SurvivorF_", "");
-			labels.Insert("gender", "female");
+			gender = "female";
 		}
 
-		if (playerType != string.Empty)
-			labels.Insert("type", playerType);
-
-		m_LabelsExtra = MetricZ_LabelUtils.MakeLabels(labels);
+		// empty name, blood or type are skipped by the schema
+		m_LabelsExtra = s_LabelSchemaExtra.Render(steamId, identity.GetId(), identity.GetName(), bloodType, gender, playerType);
 
 		ApplyLabelsToRegistry();
 	}
@@ -408,6 +400,9 @@ class MetricZ_PlayerMetrics : MetricZ_EntityMetricsBase
 		if (m_Registry.Count() == 0)
 			return;
 
+		if (m_Columns && !SeekColumns())
+			return;
+
 		foreach (MetricZ_MetricBase metric : m_Registry) {
 			if (metric == m_IsLoaded)
 				metric.SetLabels(m_LabelsExtra);
@@ -474,5 +469,13 @@ class MetricZ_PlayerMetrics : MetricZ_EntityMetricsBase
 		m_PingMaxWindow = -1;
 		m_ThrottleWindow = -1.0;
 	}
+
+	/**
+	    \brief Column store for this entity kind, if enabled.
+	*/
+	override protected MetricZ_EntityColumns GetColumns()
+	{
+		return MetricZ_EntityColumns.Players();
+	}
 }
 #endif
@@ -11,6 +11,8 @@
 */
 class MetricZ_TerritoryMetrics : MetricZ_EntityMetricsBase
 {
+	protected static ref MetricZ_LabelSchema s_LabelSchema = new MetricZ_LabelSchema("refresher_radius,longitude,latitude"); //!< Territory labels.
+
 	protected TerritoryFlag m_TerritoryFlag; //!< Parent TerritoryFlag instance.
 	ref MetricZ_MetricFloat m_Lifetime; //!< Metric: Lifetime of the territory flag.
 
@@ -19,7 +21,7 @@ class MetricZ_TerritoryMetrics : MetricZ_EntityMetricsBase
 	*/
 	void MetricZ_TerritoryMetrics()
 	{
-		m_Lifetime = new MetricZ_MetricFloat(
+		m_Lifetime = NewFloat(
 		    "territory_lifetime",
 		    "Territory flag lifetime fraction 0..1",
 		    MetricZ_MetricType.GAUGE);
@@ -62,14 +64,20 @@ class MetricZ_TerritoryMetrics : MetricZ_EntityMetricsBase
 
 		vector pos = MetricZ_Geo.GetPosition(m_TerritoryFlag);
 
-		map<string, string> labels = new map<string, string>();
-		labels.Insert("refresher_radius", GameConstants.REFRESHER_RADIUS.ToString());
-		labels.Insert("longitude", pos[0].ToString());
-		labels.Insert("latitude", pos[2].ToString());
-
-		m_Labels = MetricZ_LabelUtils.MakeLabels(labels);
+		m_Labels = s_LabelSchema.Render(
+		    GameConstants.REFRESHER_RADIUS.ToString(),
+		    pos[0].ToString(),
+		    pos[2].ToString());
 
 		ApplyLabelsToRegistry();
 	}
+
+	/**
+	    \brief Column store for this entity kind, if enabled.
+	*/
+	override protected MetricZ_EntityColumns GetColumns()
+	{
+		return MetricZ_EntityColumns.Territories();
+	}
 }
 #endif
@@ -11,6 +11,9 @@
 */
 class MetricZ_TransportMetrics : MetricZ_EntityMetricsBase
 {
+	// labels
+	protected static ref MetricZ_LabelSchema s_LabelSchema = new MetricZ_LabelSchema("class,type,hash");
+
 	// parent transport
 	protected Transport m_Transport;
 
@@ -30,46 +33,46 @@ class MetricZ_TransportMetrics : MetricZ_EntityMetricsBase
 	*/
 	void MetricZ_TransportMetrics()
 	{
-		m_Health = new MetricZ_MetricFloat(
+		m_Health = NewFloat(
 		    "transport_health",
 		    "Transport health 0..1",
 		    MetricZ_MetricType.GAUGE);
-		m_Passengers = new MetricZ_MetricInt(
+		m_Passengers = NewInt(
 		    "transport_crew_occupied",
 		    "Number of occupied seats in transport",
 		    MetricZ_MetricType.GAUGE);
-		m_SpeedMS = new MetricZ_MetricFloat(
+		m_SpeedMS = NewFloat(
 		    "transport_speed",
 		    "Transport speed, m/s",
 		    MetricZ_MetricType.GAUGE);
-		m_EngineOn = new MetricZ_MetricInt(
+		m_EngineOn = NewInt(
 		    "transport_engine_on",
 		    "Engine is on (0/1)",
 		    MetricZ_MetricType.GAUGE);
-		m_FuelFraction = new MetricZ_MetricFloat(
+		m_FuelFraction = NewFloat(
 		    "transport_fuel_fraction",
 		    "Fuel fraction 0..1",
 		    MetricZ_MetricType.GAUGE);
 
 		// position
 		if (!MetricZ_Config.Get().disabled_metrics.positions) {
-			m_PosX = new MetricZ_MetricFloat(
+			m_PosX = NewFloat(
 			    "transport_position_x",
 			    "Transport world X",
 			    MetricZ_MetricType.GAUGE);
-			m_PosZ = new MetricZ_MetricFloat(
+			m_PosZ = NewFloat(
 			    "transport_position_z",
 			    "Transport world Z",
 			    MetricZ_MetricType.GAUGE);
 
 			if (!MetricZ_Config.Get().disabled_metrics.positions_height)
-				m_PosY = new MetricZ_MetricFloat(
+				m_PosY = NewFloat(
 				    "transport_position_y",
 				    "Transport world Y",
 				    MetricZ_MetricType.GAUGE);
 
 			if (!MetricZ_Config.Get().disabled_metrics.positions_yaw)
-				m_Yaw = new MetricZ_MetricFloat(
+				m_Yaw = NewFloat(
 				    "transport_orientation",
 				    "Transport yaw degrees",
 				    MetricZ_MetricType.GAUGE);
@@ -209,8 +212,6 @@ class MetricZ_TransportMetrics : MetricZ_EntityMetricsBase
 		if (!m_Transport || m_Labels != string.Empty)
 			return;
 
-		map<string, string> labels = new map<string, string>();
-
 		string cls = m_Transport.GetType();
 		cls.TrimInPlace();
 
@@ -218,11 +219,9 @@ class MetricZ_TransportMetrics : MetricZ_EntityMetricsBase
 		type.TrimInPlace();
 		type.Replace("VehicleType", "");
 
-		labels.Insert("class", cls);
-		labels.Insert("type", type);
-		labels.Insert("hash", MetricZ_LabelUtils.PersistentHash(m_Transport).ToString());
+		string hash = MetricZ_LabelUtils.PersistentHash(m_Transport).ToString();
 
-		m_Labels = MetricZ_LabelUtils.MakeLabels(labels);
+		m_Labels = s_LabelSchema.Render(cls, type, hash);
 
 		ApplyLabelsToRegistry();
 	}
@@ -244,5 +243,13 @@ class MetricZ_TransportMetrics : MetricZ_EntityMetricsBase
 
 		return passengers;
 	}
+
+	/**
+	    \brief Column store for this entity kind, if enabled.
+	*/
+	override protected MetricZ_EntityColumns GetColumns()
+	{
+		return MetricZ_EntityColumns.Transports();
+	}
 }
 #endif
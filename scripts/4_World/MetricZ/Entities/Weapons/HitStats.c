@@ -13,22 +13,17 @@ class MetricZ_HitStats
 {
 	protected static bool s_CacheLoaded;
 
-	// Registries
-	protected static ref map<string, int> s_PlayerHit = new map<string, int>(); //!< Player hits by ammo type.
-	protected static ref map<string, int> s_CreatureHit = new map<string, int>(); //!< Creature hits by ammo type.
-
-	// Shared caches for Ammo labels
-	protected static ref map<string, string> s_LabelsAmmo = new map<string, string>(); //!< Cached labels for ammo types.
-
 	// Metrics
-	protected static ref MetricZ_MetricInt s_MetricPlayerHit = new MetricZ_MetricInt(
+	protected static ref MetricZ_MetricVector s_MetricPlayerHit = MetricZ_MetricVector.Create(
 	    "player_hit_by",
 	    "Count of hits received by players from specific ammo types",
-	    MetricZ_MetricType.COUNTER);
-	protected static ref MetricZ_MetricInt s_MetricCreatureHit = new MetricZ_MetricInt(
+	    MetricZ_MetricType.COUNTER,
+	    "ammo");
+	protected static ref MetricZ_MetricVector s_MetricCreatureHit = MetricZ_MetricVector.Create(
 	    "creature_hit_by",
 	    "Count of hits received by creatures (Zombie/Animals/eAI) from specific ammo types",
-	    MetricZ_MetricType.COUNTER);
+	    MetricZ_MetricType.COUNTER,
+	    "ammo");
 
 	/**
 	    \brief Load cache of ammo types for label persistency.
@@ -45,15 +40,8 @@ class MetricZ_HitStats
 			return;
 
 		foreach (string ammo : knownAmmo) {
-			if (!s_PlayerHit.Contains(ammo)) {
-				s_PlayerHit.Insert(ammo, 0);
-				LabelsFor(ammo);
-			}
-
-			if (!s_CreatureHit.Contains(ammo)) {
-				s_CreatureHit.Insert(ammo, 0);
-				LabelsFor(ammo);
-			}
+			s_MetricPlayerHit.Slot(ammo);
+			s_MetricCreatureHit.Slot(ammo);
 		}
 	}
 
@@ -67,7 +55,7 @@ class MetricZ_HitStats
 			return;
 
 		MetricZ_PersistentCache.Register(MetricZ_CacheKey.AMMO_TYPES, ammo);
-		IncMap(s_PlayerHit, ammo);
+		s_MetricPlayerHit.Inc(s_MetricPlayerHit.Slot(ammo));
 	}
 
 	/**
@@ -80,7 +68,7 @@ class MetricZ_HitStats
 			return;
 
 		MetricZ_PersistentCache.Register(MetricZ_CacheKey.AMMO_TYPES, ammo);
-		IncMap(s_CreatureHit, ammo);
+		s_MetricCreatureHit.Inc(s_MetricCreatureHit.Slot(ammo));
 	}
 
 	/**
@@ -92,62 +80,8 @@ class MetricZ_HitStats
 		if (!sink)
 			return;
 
-		if (s_PlayerHit.Count() > 0) {
-			s_MetricPlayerHit.WriteHeaders(sink);
-
-			foreach (string aKey, int aVal : s_PlayerHit) {
-				s_MetricPlayerHit.Set(aVal);
-				s_MetricPlayerHit.Flush(sink, s_LabelsAmmo.Get(aKey));
-			}
-		}
-
-		if (s_CreatureHit.Count() > 0) {
-			s_MetricCreatureHit.WriteHeaders(sink);
-
-			foreach (string caKey, int caVal : s_CreatureHit) {
-				s_MetricCreatureHit.Set(caVal);
-				s_MetricCreatureHit.Flush(sink, s_LabelsAmmo.Get(caKey));
-			}
-		}
-	}
-
-	/**
-	    \brief Helper to increment value in a specific map and pre-cache labels.
-	    \param metricsStore The registry map to update.
-	    \param key Normalized source key.
-	*/
-	protected static void IncMap(map<string, int> metricsStore, string key)
-	{
-		int value;
-		if (metricsStore.Find(key, value)) {
-			metricsStore.Set(key, value + 1);
-			return;
-		}
-
-		metricsStore.Insert(key, 1);
-		LabelsFor(key);
-	}
-
-	/**
-	    \brief Get or build cached labels for a ammo type.
-	    \param type Ammo type.
-	*/
-	protected static string LabelsFor(string type)
-	{
-		string labels;
-		if (s_LabelsAmmo && s_LabelsAmmo.Find(type, labels) && labels != string.Empty)
-			return labels;
-
-		map<string, string> labelsMap = new map<string, string>();
-		labelsMap.Insert("ammo", type);
-		labels = MetricZ_LabelUtils.MakeLabels(labelsMap);
-
-		if (!s_LabelsAmmo)
-			s_LabelsAmmo = new map<string, string>();
-
-		s_LabelsAmmo.Set(type, labels);
-
-		return labels;
+		s_MetricPlayerHit.FlushWithHead(sink);
+		s_MetricCreatureHit.FlushWithHead(sink);
 	}
 }
 #endif
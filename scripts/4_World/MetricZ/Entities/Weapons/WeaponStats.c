@@ -14,33 +14,31 @@
 */
 class MetricZ_WeaponStats
 {
-	protected static bool s_CacheLoaded;
-
-	protected static ref map<string, int> s_ShotsByWeapon = new map<string, int>(); //!< Total shots by weapon.
-	protected static ref map<string, int> s_CountByType = new map<string, int>(); //!< Live count by weapon type.
-	protected static ref map<string, int> s_PlayerKills = new map<string, int>(); //!< Player kills by source.
-	protected static ref map<string, int> s_CreatureKills = new map<string, int>(); //!< Creature kills by source.
+	static const int FAMILIES_COUNT = 4; //!< Number of metric families written by FlushFamily()
 
-	// weapon -> cached labels `{world=...,host=...,instance_id=...,weapon=...}`
-	protected static ref map<string, string> s_LabelsByWeapon = new map<string, string>();
+	protected static bool s_CacheLoaded;
 
 	// metrics
-	protected static ref MetricZ_MetricInt s_MetricShotsByType = new MetricZ_MetricInt(
+	protected static ref MetricZ_MetricVector s_MetricShotsByType = MetricZ_MetricVector.Create(
 	    "weapon_shots",
 	    "Shots by weapon base type",
-	    MetricZ_MetricType.COUNTER);
-	protected static ref MetricZ_MetricInt s_MetricCountByType = new MetricZ_MetricInt(
+	    MetricZ_MetricType.COUNTER,
+	    "weapon");
+	protected static ref MetricZ_MetricVector s_MetricCountByType = MetricZ_MetricVector.Create(
 	    "weapons_by_type",
 	    "Weapons in world grouped by canonical type",
-	    MetricZ_MetricType.GAUGE);
-	protected static ref MetricZ_MetricInt s_MetricPlayerKills = new MetricZ_MetricInt(
+	    MetricZ_MetricType.GAUGE,
+	    "weapon");
+	protected static ref MetricZ_MetricVector s_MetricPlayerKills = MetricZ_MetricVector.Create(
 	    "player_killed_by",
 	    "Count of players killed by source",
-	    MetricZ_MetricType.COUNTER);
-	protected static ref MetricZ_MetricInt s_MetricCreatureKills = new MetricZ_MetricInt(
+	    MetricZ_MetricType.COUNTER,
+	    "weapon");
+	protected static ref MetricZ_MetricVector s_MetricCreatureKills = MetricZ_MetricVector.Create(
 	    "creature_killed_by",
 	    "Count of creatures (Infected/Animals/AI) killed by source",
-	    MetricZ_MetricType.COUNTER);
+	    MetricZ_MetricType.COUNTER,
+	    "weapon");
 
 	/**
 	    \brief Load cache of weapon types and killers objects for label persistency.
@@ -54,26 +52,15 @@ class MetricZ_WeaponStats
 
 		array<string> knownWeapons = MetricZ_PersistentCache.GetKeys(MetricZ_CacheKey.WEAPON_TYPES);
 		if (knownWeapons) {
-			foreach (string weapon : knownWeapons) {
-				if (!s_ShotsByWeapon.Contains(weapon)) {
-					s_ShotsByWeapon.Insert(weapon, 0);
-					LabelsFor(weapon);
-				}
-			}
+			foreach (string weapon : knownWeapons)
+				s_MetricShotsByType.Slot(weapon);
 		}
 
 		array<string> knownKillers = MetricZ_PersistentCache.GetKeys(MetricZ_CacheKey.KILLER_OBJECT);
 		if (knownKillers) {
 			foreach (string killer : knownKillers) {
-				if (!s_PlayerKills.Contains(killer)) {
-					s_PlayerKills.Insert(killer, 0);
-					LabelsFor(killer);
-				}
-
-				if (!s_CreatureKills.Contains(killer)) {
-					s_CreatureKills.Insert(killer, 0);
-					LabelsFor(killer);
-				}
+				s_MetricPlayerKills.Slot(killer);
+				s_MetricCreatureKills.Slot(killer);
 			}
 		}
 	}
@@ -89,7 +76,7 @@ class MetricZ_WeaponStats
 
 		string type = weapon.MetricZ_GetLabelTypeName();
 		MetricZ_PersistentCache.Register(MetricZ_CacheKey.WEAPON_TYPES, type);
-		IncMap(s_ShotsByWeapon, type);
+		s_MetricShotsByType.Inc(s_MetricShotsByType.Slot(type));
 	}
 
 	/**
@@ -103,7 +90,7 @@ class MetricZ_WeaponStats
 
 		string type = weapon.MetricZ_GetLabelTypeName();
 		MetricZ_PersistentCache.Register(MetricZ_CacheKey.WEAPON_TYPES, type);
-		IncMap(s_CountByType, type);
+		s_MetricCountByType.Inc(s_MetricCountByType.Slot(type));
 	}
 
 	/**
@@ -117,7 +104,7 @@ class MetricZ_WeaponStats
 
 		string type = ResolveSourceName(source);
 		MetricZ_PersistentCache.Register(MetricZ_CacheKey.KILLER_OBJECT, type);
-		IncMap(s_PlayerKills, type);
+		s_MetricPlayerKills.Inc(s_MetricPlayerKills.Slot(type));
 	}
 
 	/**
@@ -131,7 +118,7 @@ class MetricZ_WeaponStats
 
 		string type = ResolveSourceName(source);
 		MetricZ_PersistentCache.Register(MetricZ_CacheKey.KILLER_OBJECT, type);
-		IncMap(s_CreatureKills, type);
+		s_MetricCreatureKills.Inc(s_MetricCreatureKills.Slot(type));
 	}
 
 	/**
@@ -145,15 +132,12 @@ class MetricZ_WeaponStats
 
 		string type = weapon.MetricZ_GetLabelTypeName();
 
-		int v;
-		if (!s_CountByType.Find(type, v))
+		int slot = s_MetricCountByType.Find(type);
+		if (slot < 0)
 			return;
 
-		v = v - 1;
-		if (v <= 0)
-			s_CountByType.Remove(type);
-		else
-			s_CountByType.Set(type, v);
+		if (s_MetricCountByType.Add(slot, -1) <= 0)
+			s_MetricCountByType.Remove(slot);
 	}
 
 	/**
@@ -165,68 +149,39 @@ class MetricZ_WeaponStats
 		if (!sink)
 			return;
 
-		// total shots + per-weapon shots
-		if (s_ShotsByWeapon.Count() > 0) {
-			s_MetricShotsByType.WriteHeaders(sink);
-
-			foreach (string key, int val : s_ShotsByWeapon) {
-				s_MetricShotsByType.Set(val);
-				s_MetricShotsByType.Flush(sink, LabelsFor(key));
-			}
-		}
-
-		// live weapons per type
-		if (s_CountByType.Count() > 0) {
-			s_MetricCountByType.WriteHeaders(sink);
-
-			foreach (string key2, int val2 : s_CountByType) {
-				s_MetricCountByType.Set(val2);
-				s_MetricCountByType.Flush(sink, LabelsFor(key2));
-			}
-		}
-
-		// player kills
-		if (s_PlayerKills.Count() > 0) {
-			s_MetricPlayerKills.WriteHeaders(sink);
-
-			foreach (string key3, int val3 : s_PlayerKills) {
-				s_MetricPlayerKills.Set(val3);
-				s_MetricPlayerKills.Flush(sink, LabelsFor(key3));
-			}
-		}
-
-		// creature kills
-		if (s_CreatureKills.Count() > 0) {
-			s_MetricCreatureKills.WriteHeaders(sink);
-
-			foreach (string key4, int val4 : s_CreatureKills) {
-				s_MetricCreatureKills.Set(val4);
-				s_MetricCreatureKills.Flush(sink, LabelsFor(key4));
-			}
-		}
+		for (int i = 0; i < FAMILIES_COUNT; ++i)
+			FlushFamily(sink, i);
 	}
 
 	/**
-	    \brief Get or build cached labels for a weapon type.
-	    \param type Normalized weapon/source name.
-	    \return string Formatted Prometheus labels.
+	    \brief Flush one weapon metric family by index.
+	    \details Families are written whole, so a resumable collector can yield between them
+	             without splitting a family that may change between frames.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param family Family index in range [0, FAMILIES_COUNT)
 	*/
-	protected static string LabelsFor(string type)
+	static void FlushFamily(MetricZ_SinkBase sink, int family)
 	{
-		string labels;
-		if (s_LabelsByWeapon && s_LabelsByWeapon.Find(type, labels) && labels != string.Empty)
-			return labels;
+		if (!sink)
+			return;
 
-		map<string, string> labelsMap = new map<string, string>();
-		labelsMap.Insert("weapon", type);
-		labels = MetricZ_LabelUtils.MakeLabels(labelsMap);
+		switch (family) {
+		case 0: // total shots + per-weapon shots
+			s_MetricShotsByType.FlushWithHead(sink);
+			break;
 
-		if (!s_LabelsByWeapon)
-			s_LabelsByWeapon = new map<string, string>();
+		case 1: // live weapons per type
+			s_MetricCountByType.FlushWithHead(sink);
+			break;
 
-		s_LabelsByWeapon.Set(type, labels);
+		case 2: // player kills
+			s_MetricPlayerKills.FlushWithHead(sink);
+			break;
 
-		return labels;
+		case 3: // creature kills
+			s_MetricCreatureKills.FlushWithHead(sink);
+			break;
+		}
 	}
 
 	/**
@@ -292,23 +247,5 @@ class MetricZ_WeaponStats
 
 		return "unknown";
 	}
-
-	/**
-	    \brief Helper to increment value in a specific map and pre-cache labels.
-	    \param metricsStore The registry map to update.
-	    \param key Normalized source key.
-	*/
-	protected static void IncMap(map<string, int> metricsStore, string key)
-	{
-		int value;
-		if (metricsStore.Find(key, value)) {
-			metricsStore.Set(key, value + 1);
-			return;
-		}
-
-		metricsStore.Insert(key, 1);
-		LabelsFor(key);
-	}
-
 }
 #endif
@@ -14,6 +14,9 @@ class MetricZ_Storage
 	protected static bool s_Initialized; //!< Initialization flag.
 	protected static string s_Labels; //!< Common labels.
 	protected static string s_LabelsExtra; //!< Extra labels.
+	protected static ref MetricZ_LabelSchema s_LabelSchemaExtra = new MetricZ_LabelSchema("game_version,save_version"); //!< Keys of extra labels.
+	protected static ref MetricZ_LabelSchema s_LabelSchemaThreshold = new MetricZ_LabelSchema("threshold_ms"); //!< Keys of frame hitch labels.
+	protected static ref MetricZ_LabelSchema s_LabelSchemaFood = new MetricZ_LabelSchema("food_type"); //!< Keys of typed food labels.
 
 	// Metrics storage registry
 	protected static ref array<ref MetricZ_MetricBase> s_Registry = new array<ref MetricZ_MetricBase>();
@@ -65,6 +68,27 @@ class MetricZ_Storage
 	    "Configured FPS cap",
 	    MetricZ_MetricType.GAUGE);
 
+	// Frame time
+	static ref MetricZ_MetricFloat s_FrameTimeP50 = new MetricZ_MetricFloat(
+	    "frame_time_p50_seconds",
+	    "Median frame time over scrape window (estimated from histogram), seconds",
+	    MetricZ_MetricType.GAUGE);
+	static ref MetricZ_MetricFloat s_FrameTimeP95 = new MetricZ_MetricFloat(
+	    "frame_time_p95_seconds",
+	    "95th percentile frame time over scrape window (estimated from histogram), seconds",
+	    MetricZ_MetricType.GAUGE);
+	static ref MetricZ_MetricFloat s_FrameTimeP99 = new MetricZ_MetricFloat(
+	    "frame_time_p99_seconds",
+	    "99th percentile frame time over scrape window (estimated from histogram), seconds",
+	    MetricZ_MetricType.GAUGE);
+	static ref MetricZ_MetricFloat s_FrameTimeMax = new MetricZ_MetricFloat(
+	    "frame_time_window_max_seconds",
+	    "Longest frame over scrape window, seconds",
+	    MetricZ_MetricType.GAUGE);
+
+	// Frames over hitch thresholds by threshold_ms label, parallel to MetricZ_FrameMonitor.s_HitchCounts
+	protected static ref array<ref MetricZ_MetricInt> s_FramesOverThreshold = new array<ref MetricZ_MetricInt>();
+
 	// Time
 	static ref MetricZ_MetricFloat s_ServerUptimeSec = new MetricZ_MetricFloat(
 	    "uptime_seconds",
@@ -390,6 +414,15 @@ class MetricZ_Storage
 		s_Registry.Insert(s_FPSSamples);
 		s_Registry.Insert(s_FPSLimit);
 
+		// Frame time
+		MetricZ_FrameMonitor.Init(MetricZ_Config.Get().thresholds.frame_hitch_ms);
+		s_Registry.Insert(MetricZ_FrameMonitor.s_FrameTime);
+		s_Registry.Insert(s_FrameTimeP50);
+		s_Registry.Insert(s_FrameTimeP95);
+		s_Registry.Insert(s_FrameTimeP99);
+		s_Registry.Insert(s_FrameTimeMax);
+		InitFramesOverThreshold();
+
 		// Time
 		s_Registry.Insert(s_ServerUptimeSec);
 		s_Registry.Insert(s_TimeUnixSec);
@@ -499,19 +532,14 @@ class MetricZ_Storage
 	*/
 	static void SetLabels()
 	{
-		map<string, string> labels = new map<string, string>();
-
-		s_Labels = MetricZ_LabelUtils.MakeLabels(labels);
+		s_Labels = MetricZ_LabelUtils.MakeLabels();
 
 		string game_version;
 		g_Game.GetVersion(game_version);
 		game_version.TrimInPlace();
 		game_version.ToLower();
 
-		labels.Insert("game_version", game_version);
-		labels.Insert("save_version", g_Game.SaveVersion().ToString());
-
-		s_LabelsExtra = MetricZ_LabelUtils.MakeLabels(labels);
+		s_LabelsExtra = s_LabelSchemaExtra.Render(game_version, g_Game.SaveVersion().ToString());
 	}
 
 	/**
@@ -533,6 +561,18 @@ class MetricZ_Storage
 		s_FPSAvg.Set(fpsAvg);
 		s_FPSSamples.Set(fpsSamples);
 
+		// frame time window stats for current scrape interval
+		float frameP50, frameP95, frameP99, frameMax;
+		MetricZ_FrameMonitor.SnapshotFrameTimes(frameP50, frameP95, frameP99, frameMax);
+		s_FrameTimeP50.Set(frameP50);
+		s_FrameTimeP95.Set(frameP95);
+		s_FrameTimeP99.Set(frameP99);
+		s_FrameTimeMax.Set(frameMax);
+
+		int hitches = s_FramesOverThreshold.Count();
+		for (int hitch = 0; hitch < hitches; hitch++)
+			s_FramesOverThreshold[hitch].Set(MetricZ_FrameMonitor.s_HitchCounts[hitch]);
+
 		// Time
 		s_ServerUptimeSec.Set(g_Game.GetTickTime());
 		s_TimeUnixSec.Set(MetricZ_Time.GameEpochSeconds());
@@ -625,6 +665,29 @@ class MetricZ_Storage
 			else
 				metric.FlushWithHead(sink, s_Labels);
 		}
+
+		if (s_FramesOverThreshold.Count() > 0) {
+			s_FramesOverThreshold[0].WriteHeaders(sink);
+			foreach (MetricZ_MetricInt framesOver : s_FramesOverThreshold)
+				framesOver.Flush(sink);
+		}
+	}
+
+	/**
+	    \brief Create one counter of frames over threshold per configured hitch threshold.
+	*/
+	protected static void InitFramesOverThreshold()
+	{
+		s_FramesOverThreshold.Clear();
+
+		foreach (int ms : MetricZ_Config.Get().thresholds.frame_hitch_ms) {
+			MetricZ_MetricInt metric = new MetricZ_MetricInt(
+			    "frames_over_threshold",
+			    "Total server frames longer than threshold_ms",
+			    MetricZ_MetricType.COUNTER);
+			metric.SetLabels(s_LabelSchemaThreshold.Render(ms.ToString()));
+			s_FramesOverThreshold.Insert(metric);
+		}
 	}
 
 	/**
@@ -681,7 +744,7 @@ class MetricZ_Storage
 
 		string labelValue = EnumTools.EnumToString(MetricZ_FoodTypes, foodType);
 		labelValue.ToLower();
-		metric.MakeLabel("food_type", labelValue);
+		metric.SetLabels(s_LabelSchemaFood.Render(labelValue));
 
 		return metric;
 	}
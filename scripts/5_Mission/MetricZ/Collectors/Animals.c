@@ -20,6 +20,11 @@ class MetricZ_CollectorAnimals : MetricZ_CollectorBase
 		return (MetricZ_Config.IsLoaded() && !MetricZ_Config.Get().disabled_metrics.animals);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.animals;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_AnimalStats.Flush(sink);
@@ -10,6 +10,8 @@
 */
 class MetricZ_CollectorAreas : MetricZ_CollectorBase
 {
+	protected ref MetricZ_EntitiesCursor m_Cursor = new MetricZ_EntitiesCursor(); //!< Resumable flush position
+
 	override string GetName()
 	{
 		return "areas";
@@ -20,9 +22,24 @@ class MetricZ_CollectorAreas : MetricZ_CollectorBase
 		return (MetricZ_Config.IsLoaded() && !MetricZ_Config.Get().disabled_metrics.areas);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.areas;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_EntitiesWriter.FlushEffectAreas(sink);
 	}
+
+	override void ResetFlush()
+	{
+		m_Cursor.Reset();
+	}
+
+	override bool FlushStep(MetricZ_SinkBase sink, float deadline)
+	{
+		return MetricZ_EntitiesWriter.FlushEffectAreasStep(sink, m_Cursor, deadline);
+	}
 }
 #endif
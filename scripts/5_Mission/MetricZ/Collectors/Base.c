@@ -29,6 +29,17 @@ class MetricZ_CollectorBase
 		return MetricZ_Config.IsLoaded();
 	}
 
+	/**
+	    \brief Collection interval of this collector.
+	    \details On cycles where the collector is not due, the exporter writes the lines
+	             of its last collection again instead of calling FlushStep().
+	    \return \p int Interval in seconds, 0 to collect every cycle.
+	*/
+	int GetIntervalSec()
+	{
+		return 0;
+	}
+
 	/**
 	    \brief Main flush method called by MetricZ.
 	    \param sink MetricZ_SinkBase sink instance
@@ -37,5 +48,27 @@ class MetricZ_CollectorBase
 	{
 		// override in subclasses
 	}
+
+	/**
+	    \brief Called once per scrape cycle before the first FlushStep().
+	    \details Override to rewind the position of a resumable collector.
+	*/
+	void ResetFlush() {}
+
+	/**
+	    \brief Resumable flush method called by MetricZ.
+	    \details Default implementation writes everything with Flush() in one call.
+	             Override to split the work across server frames: write a part,
+	             return false when `g_Game.GetTickTime() >= deadline` and continue on the next call.
+	             Do at least some work per call, other collectors are not run until this one returns true.
+	    \param sink MetricZ_SinkBase sink instance
+	    \param deadline Tick time (seconds) when the frame budget is spent
+	    \return \p bool True when the collector has finished for this cycle
+	*/
+	bool FlushStep(MetricZ_SinkBase sink, float deadline)
+	{
+		Flush(sink);
+		return true;
+	}
 }
 #endif
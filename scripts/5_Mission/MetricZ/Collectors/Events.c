@@ -20,6 +20,11 @@ class MetricZ_CollectorEvents : MetricZ_CollectorBase
 		return (MetricZ_Config.IsLoaded() && !MetricZ_Config.Get().disabled_metrics.events);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.events;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_EventStats.Flush(sink);
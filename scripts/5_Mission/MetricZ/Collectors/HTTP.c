@@ -24,6 +24,11 @@ class MetricZ_CollectorHTTP : MetricZ_CollectorBase
 		return (!cfg.disabled_metrics.http && cfg.http.enabled);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.http;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_HttpStats.Flush(sink);
@@ -20,6 +20,11 @@ class MetricZ_CollectorHits : MetricZ_CollectorBase
 		return (MetricZ_Config.IsLoaded() && !MetricZ_Config.Get().disabled_metrics.hits);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.hits;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_HitStats.Flush(sink);
@@ -10,6 +10,8 @@
 */
 class MetricZ_CollectorPlayers : MetricZ_CollectorBase
 {
+	protected ref MetricZ_EntitiesCursor m_Cursor = new MetricZ_EntitiesCursor(); //!< Resumable flush position
+
 	override string GetName()
 	{
 		return "players";
@@ -20,9 +22,24 @@ class MetricZ_CollectorPlayers : MetricZ_CollectorBase
 		return (MetricZ_Config.IsLoaded() && !MetricZ_Config.Get().disabled_metrics.players);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.players;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_EntitiesWriter.FlushPlayers(sink);
 	}
+
+	override void ResetFlush()
+	{
+		m_Cursor.Reset();
+	}
+
+	override bool FlushStep(MetricZ_SinkBase sink, float deadline)
+	{
+		return MetricZ_EntitiesWriter.FlushPlayersStep(sink, m_Cursor, deadline);
+	}
 }
 #endif
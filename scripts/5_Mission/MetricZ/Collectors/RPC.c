@@ -20,6 +20,11 @@ class MetricZ_CollectorRPC : MetricZ_CollectorBase
 		return (MetricZ_Config.IsLoaded() && !MetricZ_Config.Get().disabled_metrics.rpc_input);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.rpc;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_RpcStats.Flush(sink);
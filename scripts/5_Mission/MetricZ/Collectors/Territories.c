@@ -10,6 +10,8 @@
 */
 class MetricZ_CollectorTerritories : MetricZ_CollectorBase
 {
+	protected ref MetricZ_EntitiesCursor m_Cursor = new MetricZ_EntitiesCursor(); //!< Resumable flush position
+
 	override string GetName()
 	{
 		return "territories";
@@ -20,9 +22,24 @@ class MetricZ_CollectorTerritories : MetricZ_CollectorBase
 		return (MetricZ_Config.IsLoaded() && !MetricZ_Config.Get().disabled_metrics.territories);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.territories;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_EntitiesWriter.FlushTerritory(sink);
 	}
+
+	override void ResetFlush()
+	{
+		m_Cursor.Reset();
+	}
+
+	override bool FlushStep(MetricZ_SinkBase sink, float deadline)
+	{
+		return MetricZ_EntitiesWriter.FlushTerritoryStep(sink, m_Cursor, deadline);
+	}
 }
 #endif
@@ -10,6 +10,8 @@
 */
 class MetricZ_CollectorWeapons : MetricZ_CollectorBase
 {
+	protected int m_Family; //!< Next weapon metric family to flush
+
 	override string GetName()
 	{
 		return "weapons";
@@ -20,9 +22,32 @@ class MetricZ_CollectorWeapons : MetricZ_CollectorBase
 		return (MetricZ_Config.IsLoaded() && !MetricZ_Config.Get().disabled_metrics.weapons);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.weapons;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_WeaponStats.Flush(sink);
 	}
+
+	override void ResetFlush()
+	{
+		m_Family = 0;
+	}
+
+	override bool FlushStep(MetricZ_SinkBase sink, float deadline)
+	{
+		while (m_Family < MetricZ_WeaponStats.FAMILIES_COUNT) {
+			MetricZ_WeaponStats.FlushFamily(sink, m_Family);
+			m_Family++;
+
+			if (g_Game.GetTickTime() >= deadline)
+				break;
+		}
+
+		return (m_Family >= MetricZ_WeaponStats.FAMILIES_COUNT);
+	}
 }
 #endif
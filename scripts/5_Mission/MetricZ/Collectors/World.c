@@ -20,6 +20,11 @@ class MetricZ_CollectorWorld : MetricZ_CollectorBase
 		return MetricZ_Config.IsLoaded();
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.world;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		if (!MetricZ_Config.IsLoaded())
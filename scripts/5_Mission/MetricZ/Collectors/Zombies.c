@@ -20,6 +20,11 @@ class MetricZ_CollectorZombies : MetricZ_CollectorBase
 		return (MetricZ_Config.IsLoaded() && !MetricZ_Config.Get().disabled_metrics.zombies);
 	}
 
+	override int GetIntervalSec()
+	{
+		return MetricZ_Config.Get().intervals.zombies;
+	}
+
 	override void Flush(MetricZ_SinkBase sink)
 	{
 		MetricZ_ZombieStats.Flush(sink);
@@ -15,13 +15,19 @@ class MetricZ_Exporter
 	protected static ref MetricZ_Exporter s_Instance; // singleton instance
 
 	protected int m_FlushStep; //!< Flush State Machine - step number
+	protected int m_FlushFrames; //!< Flush State Machine - frames spent in current cycle
+	protected bool m_StepActive; //!< Flush State Machine - current collector started and not finished yet
+	protected float m_StepDuration; //!< Flush State Machine - accumulated time of current collector over frames
 	protected float m_FlushStartTime; //!< Flush State Machine - start time
 	protected float m_BeginDuration; //!< Temporary storage for current cycle timing
 	protected bool s_Busy; //!< Guard prevents overlapping scrapes
 	protected ref MetricZ_SinkBase m_ActiveSink; //!< Active sink used in Flush
 	protected ref map<string, float> m_UpdatesBuffer; //!< Values buffer by component -> value
 	protected ref map<string, string> m_LabelsCache; //!< Labels cache by component -> label
+	protected ref MetricZ_LabelSchema m_ComponentLabels; //!< Keys of profiling labels
 	protected ref array<ref MetricZ_CollectorBase> m_Collectors; //!< Registry of all metric collectors
+	protected ref array<ref MetricZ_CaptureSink> m_Captures; //!< Last rendered block of each collector, parallel to m_Collectors
+	protected MetricZ_SinkBase m_StepSink; //!< Sink of current collector: active sink or its capture
 
 	protected ref MetricZ_MetricFloat m_UpdateDuration = new MetricZ_MetricFloat(
 	    "update_duration_seconds",
@@ -35,6 +41,10 @@ class MetricZ_Exporter
 	    "sink_end_duration_seconds",
 	    "Time spent finalizing the export in the previous cycle (e.g. file close/atomic swap or HTTP transmission)",
 	    MetricZ_MetricType.GAUGE);
+	protected ref MetricZ_MetricHistogram m_UpdateDurationHist = new MetricZ_MetricHistogram(
+	    "update_duration_distribution_seconds",
+	    "Distribution of MetricZ update durations, seconds",
+	    MetricZ_MetricType.HISTOGRAM);
 	protected ref MetricZ_MetricFloat m_ScrapeDuration = new MetricZ_MetricFloat(
 	    "scrape_duration_seconds",
 	    "Duration of specific scrape components in seconds",
@@ -52,13 +62,21 @@ class MetricZ_Exporter
 
 		m_UpdatesBuffer = new map<string, float>();
 		m_LabelsCache = new map<string, string>();
+		m_ComponentLabels = new MetricZ_LabelSchema("component");
 		m_Collectors = new array<ref MetricZ_CollectorBase>();
+		m_Captures = new array<ref MetricZ_CaptureSink>();
+
+		// 1ms .. ~8s
+		m_UpdateDurationHist.SetBounds(MetricZ_MetricHistogram.ExponentialBounds(0.001, 2, 14));
 
 		if (!MetricZ_Config.IsLoaded())
 			MetricZ_Config.Get();
 
 		MetricZ_Storage.Init();
 
+		if (MetricZ_Config.Get().file.enabled)
+			MetricZ_FileSink.DeleteStaleShards();
+
 		g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(
 		          Update,
 		          MetricZ_Config.Get().settings.init_delay_sec * 1000,
@@ -120,9 +138,22 @@ class MetricZ_Exporter
 		ErrorEx("MetricZ: scrape shutting down", ErrorExSeverity.INFO);
 		MetricZ_ConfigDTO cfg = MetricZ_Config.Get();
 
+		// the sink is kept by MetricZ_Sink, close files and transactions of an unfinished cycle
+		if (m_ActiveSink)
+			m_ActiveSink.Abort();
+
 		m_ActiveSink = null;
+
+		// slot stays marked incomplete, the handle is not leaked
+		MetricZ_FlightRecorder.AbortCycle();
 		g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).Remove(ProcessFlushStep);
 
+		// keep failed chunks of this session for replay after restart
+		MetricZ_RestSpool.WriteSegment();
+
+		// publish the last scrape before its temp file is removed
+		MetricZ_FileSink.FinishPublish();
+
 		if (cfg.http.enabled)
 			return;
 
@@ -133,6 +164,7 @@ class MetricZ_Exporter
 		// stop future scrapes
 		g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).Remove(Update);
 		DeleteFile(cfg.file.temp_file_path);
+		MetricZ_FileSink.DeleteShards();
 
 		if (cfg.file.delete_on_shutdown) {
 			DeleteFile(cfg.file.prom_file_path);
@@ -144,6 +176,7 @@ class MetricZ_Exporter
 			return;
 
 		sink.SetBuffer(0);
+		sink.DisableShards();
 		if (!sink.Begin())
 			return;
 
@@ -151,6 +184,7 @@ class MetricZ_Exporter
 		MetricZ_Storage.s_Status.FlushWithHead(sink, MetricZ_Storage.GetExtraLabels());
 
 		sink.End();
+		MetricZ_FileSink.FinishPublish();
 	}
 
 	/**
@@ -170,6 +204,7 @@ class MetricZ_Exporter
 		}
 
 		m_Collectors.Insert(collector);
+		m_Captures.Insert(new MetricZ_CaptureSink());
 
 #ifdef DIAG
 		ErrorEx("MetricZ: Registered collector: " + collector.GetName(), ErrorExSeverity.INFO);
@@ -201,10 +236,17 @@ class MetricZ_Exporter
 			return;
 		}
 
+		// REST backend is down and there is no other export, skip collection entirely
+		MetricZ_ConfigDTO cfg = MetricZ_Config.Get();
+		if (cfg.http.enabled && !MetricZ_RestBreaker.Poll() && !cfg.file.enabled)
+			return;
+
 		s_Busy = true;
 		m_FlushStep = 0;
+		m_FlushFrames = 0;
+		m_StepActive = false;
 		m_FlushStartTime = g_Game.GetTickTime();
-		m_ActiveSink = MetricZ_Sink.New();
+		m_ActiveSink = MetricZ_Sink.Get();
 		m_UpdatesBuffer.Clear();
 
 		if (!m_ActiveSink || !m_ActiveSink.Begin()) {
@@ -215,6 +257,9 @@ class MetricZ_Exporter
 			return;
 		}
 
+		// only a cycle with an open sink is recorded
+		MetricZ_FlightRecorder.BeginCycle();
+
 		// store for later
 		m_BeginDuration = g_Game.GetTickTime() - m_FlushStartTime;
 
@@ -223,7 +268,11 @@ class MetricZ_Exporter
 	}
 
 	/**
-	    \brief Executes ONE block of metrics and schedules the next block
+	    \brief Executes collector steps within the frame budget and schedules the next frame
+	    \details Collectors are driven through FlushStep() until `settings.frame_budget_ms` is spent.
+	             A collector that yields is resumed in the next frame. With zero budget
+	             exactly one whole collector is flushed per frame.
+	             Collectors with an interval are recorded, and while not due their last block is replayed.
 	*/
 	protected void ProcessFlushStep()
 	{
@@ -237,16 +286,70 @@ class MetricZ_Exporter
 			return;
 		}
 
-		// flush current collector
-		MetricZ_CollectorBase currentModule = m_Collectors.Get(m_FlushStep);
-		if (currentModule && currentModule.IsEnabled()) {
+		m_FlushFrames++;
+
+		int budgetMs = MetricZ_Config.Get().settings.frame_budget_ms;
+		float deadline = float.MAX;
+		if (budgetMs > 0)
+			deadline = g_Game.GetTickTime() + budgetMs * 0.001;
+
+		while (m_FlushStep < m_Collectors.Count()) {
+			MetricZ_CollectorBase currentModule = m_Collectors.Get(m_FlushStep);
+			if (!currentModule || !currentModule.IsEnabled()) {
+				m_FlushStep++;
+				continue;
+			}
+
+			MetricZ_CaptureSink capture = m_Captures.Get(m_FlushStep);
 			float t = g_Game.GetTickTime();
-			currentModule.Flush(m_ActiveSink);
-			RecordProfile(currentModule.GetName(), t);
+
+			if (!m_StepActive) {
+				int interval = currentModule.GetIntervalSec();
+
+				m_ActiveSink.BeginBlock(currentModule.GetName());
+
+				// not due, write the block of the last collection
+				if (capture.IsFresh(interval)) {
+					capture.Replay(m_ActiveSink);
+					m_ActiveSink.EndBlock();
+					RecordProfile(currentModule.GetName(), g_Game.GetTickTime() - t);
+					m_FlushStep++;
+					continue;
+				}
+
+				m_StepSink = m_ActiveSink;
+				if (interval > 0) {
+					capture.Start(m_ActiveSink);
+					m_StepSink = capture;
+				}
+
+				currentModule.ResetFlush();
+				m_StepActive = true;
+				m_StepDuration = 0;
+			}
+
+			// flush current collector, it may yield and continue in the next frame
+			bool done = currentModule.FlushStep(m_StepSink, deadline);
+			m_StepDuration += g_Game.GetTickTime() - t;
+
+			if (done) {
+				if (m_StepSink == capture)
+					capture.Stop();
+
+				// let the sink ship the finished block
+				m_ActiveSink.EndBlock();
+
+				RecordProfile(currentModule.GetName(), m_StepDuration);
+				m_StepActive = false;
+				m_StepSink = null;
+				m_FlushStep++;
+			}
+
+			if (budgetMs <= 0 || g_Game.GetTickTime() >= deadline)
+				break;
 		}
 
 		// schedule next step for the next server frame
-		m_FlushStep++;
 		g_Game.GetCallQueue(CALL_CATEGORY_SYSTEM).Call(ProcessFlushStep);
 	}
 
@@ -255,29 +358,37 @@ class MetricZ_Exporter
 	*/
 	protected void FinishFlush()
 	{
+		m_ActiveSink.BeginBlock("exporter");
+
 		// internal profiling metrics
 		FlushProfiles(m_ActiveSink);
 
 		// write durations from previous cycle
 		m_UpdateDuration.FlushWithHead(m_ActiveSink);
+		m_UpdateDurationHist.FlushWithHead(m_ActiveSink);
 		m_SinkBeginDuration.FlushWithHead(m_ActiveSink);
 		m_SinkEndDuration.FlushWithHead(m_ActiveSink);
+		MetricZ_FileSink.FlushStats(m_ActiveSink);
+		MetricZ_BufferPool.Flush(m_ActiveSink);
+		m_ActiveSink.EndBlock();
 
 		// commit and close
 		float t = g_Game.GetTickTime();
 		m_ActiveSink.End();
 		m_ActiveSink = null;
+		MetricZ_FlightRecorder.EndCycle();
 
 		// update metrics for next cycle
 		m_SinkBeginDuration.Set(m_BeginDuration);
 		m_SinkEndDuration.Set(g_Game.GetTickTime() - t);
 		m_UpdateDuration.Set(g_Game.GetTickTime() - m_FlushStartTime);
+		m_UpdateDurationHist.Observe(m_UpdateDuration.Get());
 
 #ifdef DIAG
 		ErrorEx(
 		    string.Format(
 		        "MetricZ: FinishFlush in frame %1 took: total %2ms / sink begin %3ms / sink end %4ms",
-		        m_FlushStep,
+		        m_FlushFrames,
 		        m_UpdateDuration.Get() * 1000,
 		        m_SinkBeginDuration.Get() * 1000,
 		        m_SinkEndDuration.Get() * 1000),
@@ -293,18 +404,17 @@ class MetricZ_Exporter
 	/**
 	    \brief Records duration into map buffer.
 	    \param component Name of the component.
-	    \param startTime Tick time when the operation started.
+	    \param duration Time spent in the component over all frames, seconds.
 	*/
-	protected void RecordProfile(string component, float startTime)
+	protected void RecordProfile(string component, float duration)
 	{
-		float t = g_Game.GetTickTime() - startTime;
-		m_UpdatesBuffer.Set(component, t);
+		m_UpdatesBuffer.Set(component, duration);
 
 #ifdef DIAG
 		ErrorEx(
 		    string.Format(
 		        "MetricZ: Flush %1 in frame %2 took: %3ms",
-		        component, m_FlushStep, t * 1000),
+		        component, m_FlushFrames, duration * 1000),
 		    ErrorExSeverity.INFO);
 #endif
 	}
@@ -323,9 +433,7 @@ class MetricZ_Exporter
 			string label;
 
 			if (!m_LabelsCache.Find(key, label)) {
-				map<string, string> labelsMap = new map<string, string>();
-				labelsMap.Insert("component", key);
-				label = MetricZ_LabelUtils.MakeLabels(labelsMap);
+				label = m_ComponentLabels.Render(key);
 				m_LabelsCache.Insert(key, label);
 			}
 
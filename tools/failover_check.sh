@@ -0,0 +1,49 @@
+#!/usr/bin/env bash
+# Check REST failover of `http.urls` against two tools/ingest_stub.py instances.
+#
+#   failover_check.sh [duration_sec] [down_after] [down_sec]
+#
+# Starts stub `a` on :8098, it drops connections after <down_after> requests for
+# <down_sec> seconds, and stub `b` on :8099. Point the server at both, e.g.
+#   "urls": ["http://127.0.0.1:8098", "http://127.0.0.1:8099"]
+# with an instance_id whose primary is `a` (log line `REST primary endpoint`),
+# and run it for <duration_sec>. Fails if no commit reached `b` after the outage,
+# if a committed transaction misses chunks (split between endpoints) or if a stub
+# had to answer `resync` (ids, session or delta base of the other endpoint).
+set -euo pipefail
+
+: "${DURATION:=${1:-300}}"
+: "${DOWN_AFTER:=${2:-20}}"
+: "${DOWN_SEC:=${3:-120}}"
+
+dir="$(dirname "$0")"
+logs="$(mktemp -d)"
+trap 'kill $(jobs -p) 2>/dev/null || true' EXIT
+
+python3 "$dir/ingest_stub.py" --port 8098 --name a --quiet \
+  --down-after "$DOWN_AFTER" --down-sec "$DOWN_SEC" > "$logs/a.log" 2>/dev/null &
+python3 "$dir/ingest_stub.py" --port 8099 --name b --quiet > "$logs/b.log" 2>/dev/null &
+
+echo "stubs listen on :8098 (a) and :8099 (b), logs in $logs, waiting ${DURATION}s"
+sleep "$DURATION"
+
+fail=0
+check() {
+  if [ "$1" -eq 0 ]; then
+    echo "FAIL: $2"
+    fail=1
+  else
+    echo "ok: $2"
+  fi
+}
+
+check "$(grep -c ': commit \|: scrape of ' "$logs/a.log" || true)" "primary a received scrapes"
+check "$(grep -c ' is down' "$logs/a.log" || true)" "primary a went down"
+check "$(grep -c ': commit \|: scrape of ' "$logs/b.log" || true)" "standby b received scrapes after failover"
+errors="$(cat "$logs"/*.log | grep -c ': ERROR ' || true)"
+resyncs="$(cat "$logs"/*.log | grep -c ': resync' || true)"
+check "$((errors == 0))" "no transaction split between endpoints"
+check "$((resyncs == 0))" "no resync of dictionary or delta state"
+
+grep -h ': ERROR \|: resync' "$logs"/*.log || true
+exit "$fail"
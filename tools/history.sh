@@ -0,0 +1,101 @@
+#!/usr/bin/env bash
+# Extract cycles of the MetricZ flight recorder (history.enabled=true) as Prometheus text.
+#
+#   history.sh <history_dir> [from] [to] [instance_id]
+#
+# from/to are UNIX epoch seconds or anything `date -d` understands, both inclusive.
+# Samples of all cycles are grouped by metric family (HELP/TYPE once per family, as
+# Prometheus text requires) and get millisecond timestamps of their cycle.
+# Selected cycles are listed as `# METRICZ_CYCLE <seq> <epoch>` comments first,
+# cycles cut by a crash or freeze are listed as `# INCOMPLETE <seq> <epoch>`.
+set -euo pipefail
+
+: "${HISTORY_DIR:=${1:?Usage: $0 <history_dir> [from] [to] [instance_id]}}"
+: "${FROM:=${2:-0}}"
+: "${TO:=${3:-now}}"
+: "${INSTANCE_ID:=${4:-*}}"
+
+epoch() {
+  if [[ "$1" =~ ^[0-9]+$ ]]; then
+    echo "$1"
+  else
+    date -d "$1" +%s
+  fi
+}
+
+from="$(epoch "$FROM")"
+to="$(epoch "$TO")"
+
+shopt -s nullglob
+files=("$HISTORY_DIR"/${INSTANCE_ID}_[0-9][0-9][0-9].prom)
+[ "${#files[@]}" -eq 0 ] && {
+  >&2 echo "No history files in $HISTORY_DIR"
+  exit 1
+}
+
+# seq epoch file of every slot in range, oldest first
+mapfile -t selected < <(
+  for f in "${files[@]}"; do
+    head -n 1 "$f" | awk -v f="$f" -v from="$from" -v to="$to" \
+      '$1 == "#" && $2 == "METRICZ_CYCLE" && $4 >= from && $4 <= to { print $3, f }'
+  done | sort -k 1,1n | cut -d ' ' -f 2-
+)
+
+[ "${#selected[@]}" -eq 0 ] && {
+  >&2 echo "No cycles in range"
+  exit 1
+}
+
+# one block per family over all cycles, samples keep the time of their cycle
+awk '
+  function close_cycle() {
+    if (cycle != "" && !done)
+      incomplete = incomplete "# INCOMPLETE " cycle "\n"
+  }
+  function family_of(base,    i, n) {
+    if (base in meta)
+      return base
+    for (i = 1; i <= 5; i++) {
+      n = length(base) - length(suffix[i])
+      if (n > 0 && substr(base, n + 1) == suffix[i] && (substr(base, 1, n) in meta))
+        return substr(base, 1, n)
+    }
+    return base
+  }
+  function add(name) {
+    if (!(name in meta)) {
+      meta[name] = ""
+      order[++families] = name
+    }
+  }
+  BEGIN { split("_bucket _sum _count _total _created", suffix, " ") }
+  FNR == 1 {
+    close_cycle()
+    cycle = $3 " " $4; ts = $4 "000"; done = 0
+    cycles = cycles $0 "\n"
+    next
+  }
+  /^# METRICZ_END/ { done = 1; next }
+  /^# (HELP|TYPE) / {
+    add($3)
+    if (!(($3, $2) in head)) {
+      head[$3, $2] = 1
+      meta[$3] = meta[$3] $0 "\n"
+    }
+    next
+  }
+  /^#/ || NF < 2 { next }
+  {
+    base = $1
+    sub(/\{.*/, "", base)
+    name = family_of(base)
+    add(name)
+    samples[name] = samples[name] $0 " " ts "\n"
+  }
+  END {
+    close_cycle()
+    printf "%s%s", cycles, incomplete
+    for (i = 1; i <= families; i++)
+      printf "%s%s", meta[order[i]], samples[order[i]]
+  }
+' "${selected[@]}"
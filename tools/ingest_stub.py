@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright (c) 2025 WoozyMasta
+# Source: https://github.com/woozymasta/metricz
+"""
+Stand-in for metricz-exporter to check REST uploads of the mod by hand.
+
+Accepts chunks and commits of the MetricZ REST protocol, decodes text,
+JSON (http.serialized) and dictionary (http.dictionary) payloads, applies
+keyframe and delta commits (http.delta) and prints every committed scrape
+and replayed spool chunk as Prometheus text. Unknown dictionary sessions
+and ids, and deltas on top of an unknown base are answered with `resync`
+like the real backend does.
+
+Several stubs check hashed routing and failover of `http.urls`: every
+title names the stub and the instance_id, so the primary of each server
+is visible, and `--down-after` makes a stub drop connections like a dead
+backend until `--down-sec` passes.
+
+  ingest_stub.py                      # listen on 0.0.0.0:8098
+  ingest_stub.py --port 8099 --quiet  # only log requests, no metric text
+  ingest_stub.py --name a --down-after 50 --down-sec 120
+"""
+
+import argparse
+import json
+import sys
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from threading import Lock
+from urllib.parse import parse_qs, urlsplit
+
+RESYNC = "resync"
+
+
+class Instance:
+    """Upload state of one game server (instance_id)."""
+
+    def __init__(self):
+        self.sessions = {}  # dictionary session -> {id: series}
+        self.txns = {}  # txn -> {idx: [lines]}
+        self.states = {}  # committed delta seq -> {series: value}
+        self.current = {}  # series -> value of the last commit
+
+
+class Stub:
+    def __init__(self, args):
+        self.quiet = args.quiet
+        self.name = args.name or str(args.port)
+        self.down_after = args.down_after
+        self.down_sec = args.down_sec
+        self.down_at = None
+        self.requests = 0
+        self.lock = Lock()
+        self.instances = {}
+
+    def is_down(self):
+        """Count a request, True while the simulated outage lasts."""
+        self.requests += 1
+        if self.down_after <= 0 or self.requests <= self.down_after:
+            return False
+
+        now = time.monotonic()
+        if self.down_at is None:
+            self.down_at = now
+            print(f"# --- {self.name} is down", flush=True)
+
+        if self.down_sec <= 0 or now - self.down_at < self.down_sec:
+            return True
+
+        print(f"# --- {self.name} is up", flush=True)
+        self.requests = 0
+        self.down_at = None
+        return False
+
+    def instance(self, name):
+        return self.instances.setdefault(name, Instance())
+
+    def decode(self, inst, body, query):
+        """Decode a chunk to (lines, resync). Lines are `series value` or HELP/TYPE."""
+        fmt = query.get("format", [""])[0]
+        if fmt == "json":
+            return json.loads(body or "[]"), False
+
+        if fmt != "dict":
+            return body.splitlines(), False
+
+        session = query.get("session", [""])[0]
+        table = inst.sessions.setdefault(session, {})
+        lines = []
+        resync = False
+        for line in body.splitlines():
+            if not line:
+                continue
+            if line.startswith("@"):
+                sid, _, series = line[1:].partition(" ")
+                table[int(sid)] = series
+                continue
+
+            removed = line.startswith("-")
+            sid, _, value = line.lstrip("-").partition(" ")
+            series = table.get(int(sid))
+            if series is None:
+                if not resync:
+                    self.emit(f"resync, unknown id {sid} in session {session}", [])
+                resync = True
+                continue
+
+            if removed:
+                lines.append("# STALE " + series)
+            elif value:
+                lines.append(series + " " + value)
+            else:
+                lines.append(series)
+
+        return lines, resync
+
+    def ingest(self, parts, query, body):
+        inst = self.instance(parts[0])
+        lines, resync = self.decode(inst, body, query)
+
+        if len(parts) >= 3:
+            inst.txns.setdefault(parts[1], {})[int(parts[2])] = lines
+        elif "replay" in query:
+            part = " (partial)" if "partial" in query else ""
+            self.emit(f"replay of {parts[0]} at {query['replay'][0]}{part}", lines)
+        else:
+            # upload without transaction replaces the state at once
+            inst.current = apply({}, lines)
+            self.emit(f"scrape of {parts[0]}", render(lines, inst.current))
+
+        return resync
+
+    def commit(self, parts, query):
+        inst = self.instance(parts[0])
+        chunks = inst.txns.pop(parts[1], {})
+        lines = [line for idx in sorted(chunks) for line in chunks[idx]]
+
+        # chunks of a transaction split between endpoints never arrive here
+        if sorted(chunks) != list(range(len(chunks))) or not chunks:
+            self.emit(f"ERROR commit {parts[1]} of {parts[0]} misses chunks, got {sorted(chunks)}", [])
+
+        mode = query.get("mode", [""])[0]
+        if mode == "delta":
+            base = inst.states.get(int(query["base"][0]))
+            if base is None:
+                self.emit(f"resync, delta {parts[1]} of {parts[0]} on unknown base", [])
+                return True
+            state = apply(dict(base), lines)
+        else:
+            state = apply({}, lines)
+
+        if mode:
+            inst.states = {int(query["seq"][0]): state}
+
+        inst.current = state
+        self.emit(f"commit {parts[1]} of {parts[0]} {mode}".rstrip(), render(lines, state))
+        return False
+
+    def emit(self, title, lines):
+        print(f"# --- {self.name}: {title}", flush=True)
+        if lines and not self.quiet:
+            print("\n".join(lines), flush=True)
+
+
+def apply(state, lines):
+    """Apply samples and `# STALE` lines to series -> value state."""
+    for line in lines:
+        if line.startswith("# STALE "):
+            state.pop(line[len("# STALE "):], None)
+        elif not line.startswith("#"):
+            series, _, value = line.rpartition(" ")
+            state[series] = value
+
+    return state
+
+
+def render(lines, state):
+    """HELP/TYPE lines of the upload followed by the committed state."""
+    meta = [line for line in lines if line.startswith("# HELP") or line.startswith("# TYPE")]
+    return meta + [f"{series} {value}" for series, value in state.items()]
+
+
+class Handler(BaseHTTPRequestHandler):
+    stub = None
+
+    def do_POST(self):
+        url = urlsplit(self.path)
+        query = parse_qs(url.query)
+        parts = url.path.strip("/").split("/")
+        length = int(self.headers.get("Content-Length") or 0)
+        body = self.rfile.read(length).decode("utf-8", "replace")
+
+        with self.stub.lock:
+            down = self.stub.is_down()
+
+        if down:
+            # no response at all, the mod sees a transport error and fails over
+            self.close_connection = True
+            return
+
+        if parts[:3] == ["api", "v1", "ingest"] and len(parts) >= 4:
+            with self.stub.lock:
+                resync = self.stub.ingest(parts[3:], query, body)
+        elif parts[:3] == ["api", "v1", "commit"] and len(parts) == 5:
+            with self.stub.lock:
+                resync = self.stub.commit(parts[3:], query)
+        else:
+            self.send_error(404)
+            return
+
+        reply = (RESYNC if resync else "ok").encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(reply)))
+        self.end_headers()
+        self.wfile.write(reply)
+
+    def log_message(self, fmt, *args):
+        print("# " + fmt % args, file=sys.stderr, flush=True)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="0.0.0.0", help="listen address")
+    ap.add_argument("--port", type=int, default=8098, help="listen port")
+    ap.add_argument("--quiet", action="store_true", help="print only titles of scrapes, no metric text")
+    ap.add_argument("--name", help="stub name in titles, port by default")
+    ap.add_argument("--down-after", type=int, default=0, help="drop connections after N requests, 0 never")
+    ap.add_argument("--down-sec", type=float, default=0, help="outage length in seconds, 0 forever")
+    args = ap.parse_args()
+
+    Handler.stub = Stub(args)
+    server = ThreadingHTTPServer((args.host, args.port), Handler)
+    print(f"# listening on {args.host}:{args.port}", file=sys.stderr, flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -13,7 +13,8 @@ cat >"$out" <<'EOF'
 
 This document lists all metrics exposed by the **MetricZ** mod for
 DayZ server. Each metric includes its identifier, type
-(`GAUGE` or `COUNTER`), and description as defined in the source code.
+(`GAUGE`, `COUNTER` or `HISTOGRAM`), and description as defined in the
+source code.
 EOF
 
 while read -r file; do
@@ -22,5 +23,5 @@ while read -r file; do
     awk -f tools/metrics_extract.awk "$file"
   } >>"$out"
 done < <(
-  grep -RlE 'new\s+MetricZ_Metric(Int|Float)' ./scripts --include='*.c'
+  grep -RlE 'new\s+MetricZ_Metric(Int|Float|Histogram)|MetricZ_MetricVector\.Create' ./scripts --include='*.c'
 )
@@ -20,7 +20,7 @@ function wrap(str, width, out, n, w, i) {
 }
 
 {
-  re = "new MetricZ_Metric(Int|Float)[[:space:]]*\\(" \
+  re = "(new MetricZ_Metric(Int|Float|Histogram)|MetricZ_MetricVector\\.Create)[[:space:]]*\\(" \
        "[[:space:]]*\"([^\"]+)\"" \
        "(" \
          "[[:space:]]*,[[:space:]]*\"([^\"]*)\"" \
@@ -30,19 +30,19 @@ function wrap(str, width, out, n, w, i) {
        ")?"
 
   if (match($0, re, m)) {
-    name = m[2]
+    name = m[3]
 
     # type: default GAUGE if not specified
-    if (m[6] != "")
-      type = m[6]
+    if (m[7] != "")
+      type = m[7]
     else
       type = "GAUGE"
 
     if (type == "COUNTER")
       name = name "_total"
 
-    if (m[4] != "") {
-      desc = m[4]
+    if (m[5] != "") {
+      desc = m[5]
     } else {
       desc = name
       gsub("_", " ", desc)
@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright (c) 2025 WoozyMasta
+# Source: https://github.com/woozymasta/metricz
+"""
+Convert MetricZ binary snapshots (file.snapshot=true) to Prometheus text
+or OpenMetrics.
+
+Segments are written by MetricZ_SnapshotSink with FileSerializer.
+The assumed layout is little-endian int32 and float32, strings as int32
+length and bytes, no padding or type tags. It is not checked against the
+engine, so the reader validates every record and stops with a "layout
+mismatch" error when a length, count or tag is implausible; in that case
+compare a hex dump of the segment header (`MZSNAP`, version 1) with it.
+
+  snapshot.py metricz_1_1767225600.snap             # last cycle, Prometheus text
+  snapshot.py -o /textfile/metricz_1.prom *.snap    # last cycle, atomic write
+  snapshot.py --all --openmetrics *.snap > dump.om  # every cycle with timestamps
+  snapshot.py --all *.snap > dump.prom              # every cycle, timestamps in ms
+"""
+
+import argparse
+import math
+import os
+import struct
+import sys
+
+MAGIC = "MZSNAP"
+VERSION = 1
+TAG_FAMILY = 1
+TAG_SERIES = 2
+TAG_CYCLE = 3
+SUFFIXES = ("_bucket", "_sum", "_count", "_total", "_created")
+MAX_STRING = 1 << 20  # longest plausible HELP/TYPE line or series
+
+
+class LayoutError(ValueError):
+    """Data does not match the assumed FileSerializer layout."""
+
+
+class Truncated(Exception):
+    """Record is cut by the end of file."""
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+    def need(self, n):
+        if self.pos + n > len(self.data):
+            raise Truncated()
+
+    def int(self):
+        self.need(4)
+        (v,) = struct.unpack_from("<i", self.data, self.pos)
+        self.pos += 4
+        return v
+
+    def float(self):
+        self.need(4)
+        (v,) = struct.unpack_from("<f", self.data, self.pos)
+        self.pos += 4
+        return v
+
+    def count(self, item):
+        """Element count followed by items of `item` bytes each."""
+        at = self.pos
+        n = self.int()
+        if n < 0 or n > (len(self.data) - self.pos) // item + 1:
+            raise LayoutError(f"implausible count {n} at byte {at}")
+        return n
+
+    def string(self):
+        at = self.pos
+        n = self.int()
+        if n < 0 or n > MAX_STRING:
+            raise LayoutError(f"implausible string length {n} at byte {at}")
+        self.need(n)
+        raw = self.data[self.pos:self.pos + n]
+        if b"\0" in raw:
+            raise LayoutError(f"NUL byte in string at byte {at}")
+        self.pos += n
+        return raw.decode("utf-8", "replace")
+
+
+class Segment:
+    """Family table, series table and cycles of one segment."""
+
+    def __init__(self, path):
+        self.families = []  # [name, [lines]]
+        self.index = {}  # family name -> lines
+        self.series = {}  # id -> series text
+        self.cycles = []  # (epoch, {id: value text})
+
+        with open(path, "rb") as f:
+            r = Reader(f.read())
+
+        try:
+            if r.string() != MAGIC or r.int() != VERSION:
+                raise ValueError(f"{path}: not a MetricZ snapshot v{VERSION}")
+        except (LayoutError, Truncated):
+            raise ValueError(f"{path}: not a MetricZ snapshot or layout mismatch in the header")
+
+        try:
+            while not r.eof():
+                at = r.pos
+                tag = r.int()
+                if tag == TAG_FAMILY:
+                    line = r.string()
+                    if not line.startswith("#"):
+                        raise LayoutError(f"family record without '#' at byte {at}")
+                    self.add_family(line)
+                elif tag == TAG_SERIES:
+                    sid = r.int()
+                    if sid != len(self.series):
+                        raise LayoutError(f"series id {sid} out of order at byte {at}")
+                    self.series[sid] = r.string()
+                elif tag == TAG_CYCLE:
+                    self.cycles.append(self.read_cycle(r))
+                else:
+                    raise LayoutError(f"unknown record tag {tag} at byte {at}")
+        except Truncated:
+            # cycle cut by a crash or a concurrent write
+            print(f"{path}: truncated at byte {r.pos}", file=sys.stderr)
+        except LayoutError as e:
+            raise ValueError(f"{path}: layout mismatch, {e}") from None
+
+    def add_family(self, line):
+        parts = line.split(" ", 3)
+        name = parts[2] if len(parts) > 2 else line
+        lines = self.index.get(name)
+        if lines is not None:
+            lines.append(line)
+            return
+
+        self.index[name] = [line]
+        self.families.append([name, self.index[name]])
+
+    def read_cycle(self, r):
+        epoch = r.int()
+        values = {}
+        for _ in range(r.count(8)):
+            sid = self.series_id(r)
+            values[sid] = str(r.int())
+        for _ in range(r.count(8)):
+            sid = self.series_id(r)
+            values[sid] = prom_float(r.float())
+        for _ in range(r.count(8)):
+            sid = self.series_id(r)
+            values[sid] = r.string()
+
+        return epoch, values
+
+    def series_id(self, r):
+        at = r.pos
+        sid = r.int()
+        if sid not in self.series:
+            raise LayoutError(f"value of unknown series {sid} at byte {at}")
+        return sid
+
+    def family_of(self, series):
+        """Exact family name first, a suffix is stripped only if no family has the full name."""
+        base = series.split("{", 1)[0]
+        lines = self.index.get(base)
+        if lines is not None:
+            return base, lines
+
+        for suffix in SUFFIXES:
+            if base.endswith(suffix):
+                name = base[:-len(suffix)]
+                lines = self.index.get(name)
+                if lines is not None:
+                    return name, lines
+
+        return "", []
+
+    def collect(self, cycles, stamps, groups):
+        """Add samples of cycles to groups: family name -> [meta lines, samples]."""
+        for epoch, values in cycles:
+            stamp = ""
+            if stamps == "ms":
+                stamp = f" {epoch * 1000}"
+            elif stamps == "s":
+                stamp = f" {epoch}"
+
+            for sid in sorted(values):
+                series = self.series.get(sid)
+                if series is None:
+                    continue
+
+                name, lines = self.family_of(series)
+                group = groups.setdefault(name, [lines, []])
+                group[1].append(series + " " + values[sid] + stamp)
+
+
+def prom_float(v):
+    """Float value as Prometheus text, sampled values may be NaN or infinite."""
+    if math.isnan(v):
+        return "NaN"
+    if math.isinf(v):
+        return "+Inf" if v > 0 else "-Inf"
+    return format(v, ".7g")
+
+
+def om_meta(line):
+    """OpenMetrics counter family names have no _total suffix."""
+    parts = line.split(" ", 3)
+    if len(parts) > 2 and parts[2].endswith("_total"):
+        if parts[1] == "HELP" or (len(parts) > 3 and parts[3] == "counter"):
+            parts[2] = parts[2][:-len("_total")]
+
+    return " ".join(parts)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("files", nargs="+", help="snapshot segments, oldest first")
+    ap.add_argument("--all", action="store_true", help="write every cycle instead of the last one")
+    ap.add_argument("--openmetrics", action="store_true", help="OpenMetrics with sample timestamps")
+    ap.add_argument("-o", "--output", help="write to file atomically instead of stdout")
+    args = ap.parse_args()
+
+    try:
+        segments = [Segment(path) for path in sorted(args.files)]
+    except ValueError as e:
+        print(e, file=sys.stderr)
+        return 1
+
+    segments = [s for s in segments if s.cycles]
+    if not segments:
+        print("no cycles found", file=sys.stderr)
+        return 1
+
+    tmp = None
+    out = sys.stdout
+    if args.output:
+        tmp = args.output + ".tmp"
+        out = open(tmp, "w", encoding="utf-8", newline="\n")
+
+    # samples of several cycles need timestamps, OpenMetrics always has them
+    stamps = ""
+    if args.openmetrics:
+        stamps = "s"
+    elif args.all:
+        stamps = "ms"
+
+    groups = {}
+    if args.all:
+        for segment in segments:
+            segment.collect(segment.cycles, stamps, groups)
+    else:
+        segments[-1].collect(segments[-1].cycles[-1:], stamps, groups)
+
+    for name, (lines, samples) in groups.items():
+        for line in lines:
+            out.write((om_meta(line) if args.openmetrics else line) + "\n")
+        for sample in samples:
+            out.write(sample + "\n")
+
+    if args.openmetrics:
+        out.write("# EOF\n")
+
+    if tmp:
+        out.close()
+        os.replace(tmp, args.output)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())